@@ -3,7 +3,29 @@
 #include <optional>
 #include <chrono>
 #include "NESSweeper.h"
+#include "NESServer.h"
+#include "PoincareSection.h"
+#include "StateHistory.h"
+#include <thread>
 #define NES_MAX_NUM 9
+// 由保存的完整时程统计各状态分量在统计区间内的 RMS / 最大值 / 最小值
+static void printHistoryStats(const NESSolver& solver){
+	auto history = solver.getHistory();
+	if(!history){
+		std::cerr << "Note: no time-domain history kept (the result did not come from time-domain integration)" << std::endl;
+		return;
+	}
+	const size_t first = history->lowerBound(solver.getResultCalcStartTao() / solver.getMainFN());
+	std::vector<std::string> names;
+	std::stringstream header(stateHeader(solver.getNESNumber()));
+	for(std::string name; std::getline(header, name, ',');){
+		names.push_back(name);
+	}
+	std::cout << "component\trms\tmax\tmin" << std::endl;
+	for(size_t c = 1; c < history->getDimension(); c++){
+		std::cout << names[c] << "\t" << history->rms(c, first) << "\t" << history->max(c, first) << "\t" << history->min(c, first) << std::endl;
+	}
+}
 struct Arguments{
     std::optional<double> initialAStar;
     // tao = f_n * t
@@ -19,20 +41,54 @@ struct Arguments{
 	std::optional<double> ksi;
 
 	std::optional<std::string> outputFile;
+	std::optional<std::string> cycleOutputFile;
+	std::optional<size_t> outputChunkSize;
+	std::optional<std::string> poincareFile;
+	std::optional<bool> poincareBinary;
+	std::optional<bool> spectrum;
+	std::optional<bool> energy;
+	std::optional<bool> stroke;
+	std::optional<double> maxStroke;
+	std::optional<bool> historyStats;
+	std::optional<std::string> historyDir;
 	std::optional<std::string> config;		// single(default) 3m3u
-	std::optional<std::string> objFunc;	// avg max avg_max(default)
+	std::optional<std::string> objFunc;	// avg max avg_max(default) tet
 	std::optional<std::string> sweepParamsFile;
+	std::optional<std::string> paretoFile;
+	std::optional<std::string> topKFile;
+	std::optional<int> topK;
+	std::optional<bool> noCsv;
 	std::optional<bool> showTime;
 	std::optional<bool> sweep;
 	std::optional<bool> printDetail;
 	std::optional<bool> binary;
+	std::optional<bool> serve;
+	std::optional<std::string> socketPath;
 
 	std::optional<int> nesNum;
+	std::optional<int> threadNum;
+	std::optional<bool> warmStart;
+	std::optional<double> warmCalcStartTao;
+	std::optional<double> warmTolerance;
+	std::optional<size_t> warmCheckInterval;
 	std::vector<std::optional<double>> mr = std::vector<std::optional<double>>(NES_MAX_NUM);
     std::vector<std::optional<double>> kr = std::vector<std::optional<double>>(NES_MAX_NUM);
     std::vector<std::optional<double>> cr = std::vector<std::optional<double>>(NES_MAX_NUM);
 
 	std::optional<double> totalMassRatio;
+	std::optional<double> divergenceAStar;
+	std::optional<std::string> method;
+	std::optional<double> shootingTransientTao;
+	std::optional<unsigned int> harmonicNumber;
+	std::optional<bool> slowFlowStart;
+	std::optional<bool> linearPrescreen;
+	std::optional<std::string> integrator;
+	// 多保真度筛选 (扫描时): 各级的 totalTao / taoStepSize / 保留比例
+	std::vector<double> screenTotalTao;
+	std::vector<double> screenTaoStepSize;
+	std::vector<double> keepRatio;
+	std::vector<std::string> screenMethod;
+	std::vector<double> extraCalcStartTao;
 	
 
 };
@@ -43,6 +99,7 @@ void parseArguments(int argc, char* argv[], Arguments& arg){
     
     app.add_option("-a,--initial-a-star", arg.initialAStar, "Initial AStar");
     app.add_option("--rctao", arg.resultCalcStartTao, "Result Calculation Start Time");
+	app.add_option("--extra-rctao", arg.extraCalcStartTao, "Additional result calculation start taos, evaluated in the same run and reported as extra yRms/yMax columns");
 	app.add_option("--ctao", arg.totalTao, "Total Calculation Tao");
 	app.add_option("--dtao", arg.taoStepSize, "Tao Step Size");
 
@@ -52,19 +109,72 @@ void parseArguments(int argc, char* argv[], Arguments& arg){
 	app.add_option("--ksi-design", arg.ksiDesign, "Design damping ratio");
 
 	app.add_option("--ustar", arg.UStar, "Reduced Wind Velocity");
+	app.add_option("--diverge-a-star", arg.divergenceAStar, "Abort a run when the main structure A* exceeds this bound (default 1.0)");
+	app.add_option("--method", arg.method, "Solver method: time (time-domain RK4, default), shooting (periodic orbit, falls back to time when not found or unstable), hb (harmonic balance, falls back to time when not converged or unstable) or slow (averaged slow-flow model, approximate: yRms within about 1-10% of time, about 0.4 ms per case with a stable steady response and 30-60 ms when the envelope has to be integrated, against 1-2 s for time)");
+	app.add_option("--shoot-ttao", arg.shootingTransientTao, "Transient Tao integrated before shooting (default 50)");
+	app.add_option("--integrator", arg.integrator, "Time-domain integrator: rk4 (default), rodas3 or ros2 (L-stable Rosenbrock, only for stiff NES designs: their numerical damping biases non-stiff limit cycles at large --dtao, e.g. ros2 removes the reference limit cycle entirely and rodas3 overestimates yRms by 10% at --dtao 0.05; check against rk4), etdrk4 (exponential integrator, structural linear part exact), ck4 (low-storage 5-stage RK4), tsit5, butcher6 or cv8 (explicit RK of order 5, 6 and 8, accurate at larger --dtao)");
+	app.add_option("--harmonics", arg.harmonicNumber, "Number of harmonics for hb (default 7)");
+	app.add_flag("--slow-start", arg.slowFlowStart, "Start time-domain runs from the response predicted by the slow-flow model");
+	app.add_flag("--linear-prescreen", arg.linearPrescreen, "\
+		Check the linearization about rest first; linearly stable cases get the analytical decaying response");
 	app.add_option("--total-mass-ratio", arg.totalMassRatio, "Total Mass Ratio");
 	app.add_option("-n,--nes-number", arg.nesNum, "NES Number (0 ~ "+std::to_string(NES_MAX_NUM)+")");
 
 	app.add_option("--out", arg.outputFile, "Output File Path (State Time History or Sweeping Results)");
+	app.add_option("--out-chunk", arg.outputChunkSize, "Write the state time history (--out) as chunked columnar binary with this many samples per chunk, indexed by per-chunk min/max for windowed reads (ColumnarHistoryReader); time-domain runs only");
+	app.add_option("--cycle-out", arg.cycleOutputFile, "Per-cycle table (period, peak, trough, cycle RMS) of the main and NES relative displacements, time-domain runs only");
+	app.add_option("--poincare-out", arg.poincareFile, "Poincare section output: states at upward zero crossings of the main velocity within the statistics window, prefixed by case index (and swept parameters when sweeping); time-domain runs only");
+	app.add_flag("--poincare-binary", arg.poincareBinary, "Write the Poincare section as raw doubles instead of CSV");
+	app.add_flag("--spectrum", arg.spectrum, "Spectral analysis of the main and NES relative displacements over the statistics window: dominant frequency (f/fn), sub-/super-harmonic energy fractions and modulation index per channel as extra columns; time-domain runs only");
+	app.add_flag("--energy", arg.energy, "Energy balance over the statistics window: aero input power / (k D^2 omega), main-damping and per-NES damper fractions of the dissipated energy as extra columns; time-domain runs only (implied by -j tet)");
+	app.add_flag("--stroke", arg.stroke, "NES stroke statistics over the statistics window: relative displacement RMS and max (/D) and peak cubic spring force (N) per NES as extra columns; time-domain runs only");
+	app.add_flag("--history-stats", arg.historyStats, "\
+		Keep the full state history of a single run and print RMS, max and min of every state component \
+		(m, m/s) over the statistics window after the results; time-domain runs with --config single only");
+	app.add_option("--history-dir", arg.historyDir, "\
+		Keep the --history-stats history in an mmap'd temporary file in this directory instead of memory, for very long runs");
+	app.add_option("--max-stroke", arg.maxStroke, "Stroke constraint when sweeping: configurations whose NES max stroke (/D) exceeds this in any case are excluded from top-K and Pareto results (implies --stroke)");
 	app.add_option("--config", arg.config, 
 		"Config for Single Calculation: \n\
 		single: use indicated params(Ustar, fn); \n\
 		3m3u: calculate 3 modes and 3 UStars using built-in params(Ustar, fn)");
 	app.add_option("-j,--objective-funtion", arg.objFunc, "\
 		Objective Function. Only avaliable when config is 3m3u.\n\
-		avg, average, max, max_avg\
+		avg, average, max, max_avg, tet (maximize the NES share of dissipated energy)\
 		");
+	app.add_option("-p,--threads", arg.threadNum, "Thread number when sweeping (default 1) or serving (default: all cores)");
+	app.add_flag("--serve", arg.serve, "\
+		Batch worker mode: read JSON-line jobs from stdin (or --socket) and stream JSON-line results.\n\
+		Command line parameters are the defaults of every job.");
+	app.add_option("--socket", arg.socketPath, "Listen on this local Unix socket instead of stdin in --serve mode");
+	app.add_flag("--warm-start", arg.warmStart, "\
+		Continuation when sweeping: seed each run with the final state of its neighbor on the sweep line.\n\
+		Off by default: a continued run may settle on a different attractor (response branch) than the cold start from --initial-a-star, \
+		so results can differ from a sweep without it (see --warm-check)");
+	app.add_option("--warm-rctao", arg.warmCalcStartTao, "Result Calculation Start Tao of warm-started runs (default 50)");
+	app.add_option("--warm-tol", arg.warmTolerance, "\
+		Relative yRms change to the neighbor above which a warm-started run is redone cold (default 0.05)");
+	app.add_option("--warm-check", arg.warmCheckInterval, "\
+		Every N-th warm-started configuration is also run cold and the cold result is used. Warm results are only written once a later check \
+		(or a final check at the end of the sweep line) agrees within --warm-tol; otherwise they and the rest of that sweep line are run cold \
+		(default 4, 0 disables the check and writes warm results unchecked)");
 	app.add_option("--sweep-params", arg.sweepParamsFile, "Sweep Parameters File Path");
+	app.add_option("--pareto-out", arg.paretoFile, "\
+		Pareto Front File Path when sweeping (yRms, yMax, total mass ratio).\n\
+		An existing front in this file is merged.");
+	app.add_option("--top-k", arg.topK, "Keep the K best configurations under the objective function when sweeping");
+	app.add_option("--top-out", arg.topKFile, "Top-K Configurations File Path");
+	app.add_flag("--no-csv", arg.noCsv, "Do not write the full sweeping results (use with --top-k or --pareto-out)");
+	app.add_option("--screen-ctao", arg.screenTotalTao, "\
+		Total Calculation Tao of each screening level when sweeping (successive halving).\n\
+		Survivors of the last level are evaluated with --ctao and --dtao.");
+	app.add_option("--screen-dtao", arg.screenTaoStepSize, "Tao Step Size of each screening level");
+	app.add_option("--keep-ratio", arg.keepRatio, "\
+		Fraction of configurations kept after each screening level.\n\
+		One value for all levels or one value per level (default 0.5).");
+	app.add_option("--screen-method", arg.screenMethod, "\
+		Solver method of each screening level, e.g. slow for the slow-flow model.\n\
+		One value for all levels or one value per level (default time).");
 	app.add_flag("-t,--time", arg.showTime, "Show calculation time flag");
 	app.add_flag("-s,--sweep", arg.sweep, "Sweep flag");
 	app.add_flag("--pd,--print-details", arg.printDetail, "Print details flag");
@@ -92,6 +202,25 @@ void parseArguments(int argc, char* argv[], Arguments& arg){
     }
 }
 void checkArgValidation(Arguments& arg){
+	if(!arg.serve.has_value()){arg.serve = false;}
+	if(arg.serve.value()){
+		// 常驻模式: 命令行参数只作为任务默认值, 由各任务自行检查
+		if(arg.sweep.has_value() && arg.sweep.value()){
+			throw std::runtime_error("--serve can't be used together with --sweep.");
+		}
+		if(!arg.nesNum.has_value()){arg.nesNum = 1;}
+		if(!arg.threadNum.has_value()){arg.threadNum = std::max(std::thread::hardware_concurrency(), 1u);}
+		// 结果只以 JSON 行返回, 不写文件
+		if(arg.cycleOutputFile.has_value() || arg.poincareFile.has_value() || arg.outputChunkSize.has_value()){
+			throw std::runtime_error("--cycle-out, --poincare-out and --out-chunk are not available with --serve.");
+		}
+		if(arg.maxStroke.has_value()){
+			throw std::runtime_error("--max-stroke is only used when sweeping; request \"stroke\" in --serve jobs instead.");
+		}
+	}
+	else if(arg.socketPath.has_value()){
+		throw std::runtime_error("--socket requires --serve.");
+	}
 	if(!arg.nesNum.has_value()){
 		throw std::runtime_error("NES number is required. Use \"-n\" to specify.");
 	}
@@ -104,6 +233,19 @@ void checkArgValidation(Arguments& arg){
 	if(!arg.fDesign.has_value()){arg.fDesign = 1.117;}
 	if(!arg.ksiDesign.has_value()){arg.ksiDesign = 0.003;}
 	if(!arg.ksi.has_value()){arg.ksi = 0.003;}
+	if(!arg.divergenceAStar.has_value()){arg.divergenceAStar = 1.0;}
+	if(!arg.method.has_value()){arg.method = "time";}
+	if(!arg.shootingTransientTao.has_value()){arg.shootingTransientTao = 50;}
+	if(!arg.harmonicNumber.has_value()){arg.harmonicNumber = 7;}
+	if(!arg.slowFlowStart.has_value()){arg.slowFlowStart = false;}
+	if(!arg.linearPrescreen.has_value()){arg.linearPrescreen = false;}
+	if(!arg.integrator.has_value()){arg.integrator = "rk4";}
+	const IntegratorType integratorType = parseIntegratorType(arg.integrator.value());
+	if(integratorType == IntegratorType::Ros2 || integratorType == IntegratorType::Rodas3){
+		std::cerr << "Warning: " << arg.integrator.value() << " is meant for stiff NES designs; "
+			<< "on non-stiff designs its numerical damping biases the limit cycle at large --dtao (compare with rk4)." << std::endl;
+	}
+	parseSolverMethod(arg.method.value());
 	
 	if((!arg.config.has_value())){arg.config = "single";}
 
@@ -124,10 +266,41 @@ void checkArgValidation(Arguments& arg){
 	}else{
 		throw std::runtime_error("Unsupported config.");
 	}
+	if(!arg.objFunc.has_value()){arg.objFunc = "avg_max";}
+	parseObjective(arg.objFunc.value());
 	if(!arg.showTime.has_value()){arg.showTime = false;}
 	if(!arg.sweep.has_value()){arg.sweep = false;}
 	if(!arg.printDetail.has_value()){arg.printDetail = false;}
+	if(!arg.noCsv.has_value()){arg.noCsv = false;}
+	if(!arg.topK.has_value()){arg.topK = 0;}
+	if(!arg.threadNum.has_value()){arg.threadNum = 1;}
+	if(arg.threadNum.value() < 1){
+		throw std::runtime_error("Thread number must be positive.");
+	}
 	
+	if(!arg.poincareBinary.has_value()){arg.poincareBinary = false;}
+	if(arg.outputChunkSize.has_value() && arg.outputChunkSize.value() == 0){
+		throw std::runtime_error("Chunk size of the history output must be positive.");
+	}
+	if(!arg.spectrum.has_value()){arg.spectrum = false;}
+	if(!arg.energy.has_value()){arg.energy = false;}
+	if(!arg.stroke.has_value()){arg.stroke = false;}
+	if(arg.maxStroke.has_value() && arg.maxStroke.value() <= 0.0){
+		throw std::runtime_error("Stroke limit must be positive.");
+	}
+	if(!arg.historyStats.has_value()){arg.historyStats = false;}
+	if(arg.historyDir.has_value() && !arg.historyStats.value()){
+		throw std::runtime_error("--history-dir requires --history-stats.");
+	}
+	if(arg.historyStats.value() && (arg.serve.value() || arg.sweep.value() || arg.config.value() != "single")){
+		throw std::runtime_error("--history-stats is only available for single runs (--config single).");
+	}
+	if(arg.serve.value()){
+		if(!arg.outputFile.has_value()){arg.outputFile = "";}
+		if(!arg.fNatural.has_value()){arg.fNatural = 1.117;}
+		if(!arg.UStar.has_value()){arg.UStar = 1.7;}
+		return;
+	}
 	if(arg.sweep == false){
 		// 非扫描的情况：
 		// 检验nes参数是否全面
@@ -165,6 +338,18 @@ void checkArgValidation(Arguments& arg){
 		if(arg.totalMassRatio.has_value()){
 			throw std::runtime_error("Total mass ratio can't be specified when not sweeping.");
 		}
+		if(arg.paretoFile.has_value()){
+			throw std::runtime_error("Pareto front file can only be specified when sweeping.");
+		}
+		if(arg.topK.value() != 0 || arg.topKFile.has_value() || arg.noCsv.value()){
+			throw std::runtime_error("Top-K options can only be specified when sweeping.");
+		}
+		if(arg.warmStart.has_value() || arg.warmCalcStartTao.has_value() || arg.warmTolerance.has_value() || arg.warmCheckInterval.has_value()){
+			throw std::runtime_error("Warm start can only be specified when sweeping.");
+		}
+		if(!arg.screenTotalTao.empty() || !arg.screenTaoStepSize.empty() || !arg.keepRatio.empty() || !arg.screenMethod.empty()){
+			throw std::runtime_error("Screening levels can only be specified when sweeping.");
+		}
 		
 	}else{
 		// 扫描的情况：
@@ -174,9 +359,30 @@ void checkArgValidation(Arguments& arg){
 		if(!arg.totalMassRatio.has_value()){
 			throw std::runtime_error("Total mass ratio must be specified when sweeping.");
 		}
+		if(arg.topK.value() < 0){
+			throw std::runtime_error("K of top-K configurations must be positive.");
+		}
+		if(arg.topKFile.has_value() && arg.topK.value() == 0){
+			throw std::runtime_error("--top-out requires --top-k.");
+		}
+		if(arg.noCsv.value()){
+			if(arg.outputFile.has_value()){
+				throw std::runtime_error("Output file can't be specified with --no-csv.");
+			}
+			if(arg.topK.value() == 0 && !arg.paretoFile.has_value()){
+				throw std::runtime_error("--no-csv requires --top-k or --pareto-out.");
+			}
+			arg.outputFile = "";
+		}
 		if(!arg.outputFile.has_value()){
 			throw std::runtime_error("Output file must be specified when sweeping.");
 		}
+		if(arg.cycleOutputFile.has_value()){
+			throw std::runtime_error("--cycle-out is not available when sweeping.");
+		}
+		if(arg.outputChunkSize.has_value()){
+			throw std::runtime_error("--out-chunk is not available when sweeping.");
+		}
 		for(int i = 1; i <= NES_MAX_NUM; i++){
 			if(arg.mr[i-1].has_value() || arg.kr[i-1].has_value() || arg.cr[i-1].has_value()){
 				throw std::runtime_error(
@@ -184,10 +390,83 @@ void checkArgValidation(Arguments& arg){
 					command when sweeping. Use --sweep-params and specify in a file.");
 			}
 		}
+		if(!arg.warmStart.has_value()){arg.warmStart = false;}
+		if(!arg.warmCalcStartTao.has_value()){arg.warmCalcStartTao = 50.0;}
+		if(!arg.warmTolerance.has_value()){arg.warmTolerance = 0.05;}
+		if(!arg.warmCheckInterval.has_value()){arg.warmCheckInterval = 4;}
+		if(arg.warmCalcStartTao.value() < 0.0 || arg.warmTolerance.value() < 0.0){
+			throw std::runtime_error("Warm start tao and tolerance must not be negative.");
+		}
+		size_t levelNum = arg.screenTotalTao.size();
+		if(arg.screenTaoStepSize.size() != levelNum){
+			throw std::runtime_error("--screen-ctao and --screen-dtao must have the same number of values.");
+		}
+		if(arg.keepRatio.empty()){arg.keepRatio = std::vector<double>(levelNum, 0.5);}
+		if(arg.keepRatio.size() == 1){arg.keepRatio = std::vector<double>(levelNum, arg.keepRatio[0]);}
+		if(arg.keepRatio.size() != levelNum){
+			throw std::runtime_error("--keep-ratio must have one value or one value per screening level.");
+		}
+		if(arg.screenMethod.empty()){arg.screenMethod = std::vector<std::string>(levelNum, "time");}
+		if(arg.screenMethod.size() == 1){arg.screenMethod = std::vector<std::string>(levelNum, arg.screenMethod[0]);}
+		if(arg.screenMethod.size() != levelNum){
+			throw std::runtime_error("--screen-method must have one value or one value per screening level.");
+		}
+		for(size_t i = 0; i < levelNum; i++){
+			if(arg.screenTotalTao[i] <= 0.0 || arg.screenTaoStepSize[i] <= 0.0){
+				throw std::runtime_error("Screening tao and tao step size must be positive.");
+			}
+			if(arg.keepRatio[i] <= 0.0 || arg.keepRatio[i] > 1.0){
+				throw std::runtime_error("Keep ratio must be in (0, 1].");
+			}
+			parseSolverMethod(arg.screenMethod[i]);
+		}
 	}
 	
 }
+void serve(const Arguments& arg){
+	NESJob defaults;
+	defaults.nesNum = arg.nesNum.value();
+	for(int i = 1; i <= defaults.nesNum; i++){
+		defaults.mr.push_back(arg.mr[i-1].value_or(0.01));
+		defaults.kr.push_back(arg.kr[i-1].value_or(1.0));
+		defaults.cr.push_back(arg.cr[i-1].value_or(1.0));
+	}
+	defaults.config = arg.config.value();
+	defaults.objective = arg.objFunc.value();
+	defaults.UStar = arg.UStar.value();
+	defaults.fNatural = arg.fNatural.value();
+	defaults.initialAStar = arg.initialAStar.value();
+	defaults.totalTao = arg.totalTao.value();
+	defaults.resultCalcStartTao = arg.resultCalcStartTao.value();
+	defaults.taoStepSize = arg.taoStepSize.value();
+	defaults.fDesign = arg.fDesign.value();
+	defaults.ksiDesign = arg.ksiDesign.value();
+	defaults.ksi = arg.ksi.value();
+	defaults.divergenceAStar = arg.divergenceAStar.value();
+	defaults.method = arg.method.value();
+	defaults.extraCalcStartTaos = arg.extraCalcStartTao;
+	defaults.shootingTransientTao = arg.shootingTransientTao.value();
+	defaults.harmonicNumber = arg.harmonicNumber.value();
+	defaults.slowFlowStart = arg.slowFlowStart.value();
+	defaults.linearPrescreen = arg.linearPrescreen.value();
+	defaults.spectrum = arg.spectrum.value();
+	defaults.energy = arg.energy.value();
+	defaults.stroke = arg.stroke.value();
+	defaults.integrator = arg.integrator.value();
+
+	NESServer server(defaults, arg.threadNum.value());
+	if(arg.socketPath.has_value()){
+		server.serveUnixSocket(arg.socketPath.value());
+	}
+	else{
+		server.serveStream(std::cin, std::cout);
+	}
+}
 void run(const Arguments& arg){
+	if(arg.serve.value()){
+		serve(arg);
+		return;
+	}
 	auto start = std::chrono::high_resolution_clock::now();
 	NESSolver solver(arg.nesNum.value());
 	solver.setMainDampingRatio(arg.ksi.value());
@@ -195,12 +474,45 @@ void run(const Arguments& arg){
 	solver.setInitialAStar(arg.initialAStar.value());
 	solver.setTotalTao(arg.totalTao.value());
 	solver.setResultCalcStartTao(arg.resultCalcStartTao.value());
+	solver.setExtraCalcStartTaos(arg.extraCalcStartTao);
 	solver.setTaoStepSize(arg.taoStepSize.value());
+	solver.setDivergenceAStar(arg.divergenceAStar.value());
+	solver.setMethod(parseSolverMethod(arg.method.value()));
+	solver.setShootingTransientTao(arg.shootingTransientTao.value());
+	solver.setHarmonicNumber(arg.harmonicNumber.value());
+	solver.setSlowFlowStart(arg.slowFlowStart.value());
+	solver.setLinearPrescreen(arg.linearPrescreen.value());
+	solver.setIntegrator(parseIntegratorType(arg.integrator.value()));
+	solver.setSpectralAnalysis(arg.spectrum.value());
+	solver.setEnergyMetrics(arg.energy.value() || parseObjective(arg.objFunc.value()) == ObjectiveType::Tet);
+	solver.setStrokeStatistics(arg.stroke.value() || arg.maxStroke.has_value());
 	
 	solver.setFD(arg.fDesign.value());
 	if(arg.sweep.value()){
 		NESSweeper sweeper(solver, arg.sweepParamsFile.value(), arg.totalMassRatio.value());
 		sweeper.setOutFile(arg.outputFile.value());
+		if(arg.maxStroke.has_value()){
+			sweeper.setStrokeLimit(arg.maxStroke.value());
+		}
+		if(arg.poincareFile.has_value()){
+			sweeper.setPoincareFile(arg.poincareFile.value(), arg.poincareBinary.value());
+		}
+		if(arg.paretoFile.has_value()){
+			sweeper.setParetoFile(arg.paretoFile.value());
+		}
+		if(arg.topK.value() > 0){
+			sweeper.setTopK(arg.topK.value(), arg.topKFile.value_or(""));
+		}
+		sweeper.setThreadNum(arg.threadNum.value());
+		if(arg.warmStart.value()){
+			sweeper.setWarmStart(arg.warmCalcStartTao.value(), arg.warmTolerance.value(), arg.warmCheckInterval.value());
+		}
+		sweeper.setObjective(parseObjective(arg.objFunc.value()));
+		std::vector<FidelityLevel> levels;
+		for(size_t i = 0; i < arg.screenTotalTao.size(); i++){
+			levels.push_back(FidelityLevel{arg.screenTotalTao[i], arg.screenTaoStepSize[i], arg.keepRatio[i], parseSolverMethod(arg.screenMethod[i])});
+		}
+		sweeper.setFidelityLevels(levels);
 		if(arg.printDetail.value()){
 			sweeper.printDatas();
 		}
@@ -212,6 +524,15 @@ void run(const Arguments& arg){
 		
 		
 		solver.setOutput(arg.outputFile.value());
+		if(arg.outputChunkSize.has_value()){
+			solver.setOutputChunkSize(arg.outputChunkSize.value());
+		}
+		if(arg.cycleOutputFile.has_value()){
+			solver.setCycleOutput(arg.cycleOutputFile.value());
+		}
+		if(arg.historyStats.value()){
+			solver.setKeepHistory(true, arg.historyDir.value_or(""));
+		}
 		
 		for(int i = 1; i <= arg.nesNum; i++){
 			solver.setNESMr(i, arg.mr[i-1].value());
@@ -221,24 +542,38 @@ void run(const Arguments& arg){
 		
 		if(arg.printDetail.value()){solver.printAll();}
 		
+		if(arg.poincareFile.has_value()){
+			solver.setPoincareSection(true);
+		}
+		std::vector<DisplacementResults> results;
 		if(arg.config.value() == "single"){
 			solver.setMainFN(arg.fNatural.value());
 			solver.setUStar(arg.UStar.value());
-			auto result = solver.run();
-			result.print();
+			results.push_back(solver.run());
 		}
 		else if (arg.config.value() == "1m3u"){
-			auto results = solver.runConfig1m3u();
-			
-			for(const auto& result : results){
-				result.print();
-			}
+			results = solver.runConfig1m3u();
 		}
 		else if (arg.config.value() == "3m3u"){
-			auto results = solver.runConfig3m3u();
-			
-			for(const auto& result : results){
-				result.print();
+			results = solver.runConfig3m3u();
+		}
+		for(const auto& result : results){
+			result.print();
+		}
+		if(arg.historyStats.value()){
+			printHistoryStats(solver);
+		}
+		if(arg.poincareFile.has_value()){
+			const bool binary = arg.poincareBinary.value();
+			std::ofstream sectionOfs(arg.poincareFile.value(), binary ? std::ios::binary : std::ios::out);
+			if(!sectionOfs){
+				throw std::runtime_error("Cannot open Poincare section file \"" + arg.poincareFile.value() + "\".");
+			}
+			if(!binary){
+				sectionOfs << "case," << stateHeader(arg.nesNum.value()) << "\n";
+			}
+			for(size_t c = 0; c < results.size(); c++){
+				writeSectionPoints(sectionOfs, { static_cast<double>(c) }, results[c].sectionPoints, solver.getDimension(), binary);
 			}
 		}
 		
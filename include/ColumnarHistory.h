@@ -0,0 +1,71 @@
+#pragma once
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <vector>
+// 分块列存储的时程文件 (本机字节序):
+//   文件头: "NESFDMH1", uint32 版本, uint32 分量数 d, uint64 块长度 (样本数), uint32 列名长度, 列名 (逗号分隔)
+//   数据块: 每块依次存放 d 列, 每列为该块的连续 double 序列 (末块可以不满)
+//   索引: 每块 uint64 首样本序号, uint64 样本数, 以及每列的 uint64 文件偏移, double 最小值, double 最大值
+//   文件尾: uint64 块数, uint64 总样本数, uint64 索引偏移, "NESFDMI1"
+// 读取时只需文件尾和索引即可定位与时间窗重叠的块, 或直接由各块的 min/max 给出概览
+class ColumnarHistoryWriter{
+public:
+    ColumnarHistoryWriter(const std::string& path, size_t dimension_, size_t chunkSize_, const std::string& columnNames);
+    ~ColumnarHistoryWriter();
+    ColumnarHistoryWriter(const ColumnarHistoryWriter&) = delete;
+    ColumnarHistoryWriter& operator=(const ColumnarHistoryWriter&) = delete;
+    void update(const std::vector<double>& state);
+    // 写出未满的块和索引; 析构时自动调用
+    void close();
+private:
+    struct ColumnIndex{
+        uint64_t offset;
+        double min;
+        double max;
+    };
+    std::ofstream ofs;
+    size_t dimension;
+    size_t chunkSize;
+    size_t buffered = 0;
+    uint64_t sampleNum = 0;
+    std::vector<double> buffer;     // 当前块, 按列存放
+    std::vector<uint64_t> chunkFirst, chunkCount;
+    std::vector<ColumnIndex> index; // 块数 x 分量数
+    void flush();
+};
+// 时程文件的读取: 打开时只读入文件头和索引
+class ColumnarHistoryReader{
+public:
+    // 一个块在某列上的概览
+    struct ChunkSummary{
+        double tBegin;
+        double tEnd;
+        double min;
+        double max;
+    };
+    explicit ColumnarHistoryReader(const std::string& path);
+    size_t getDimension() const{return dimension;};
+    size_t getChunkSize() const{return chunkSize;};
+    uint64_t getSampleNum() const{return sampleNum;};
+    size_t getChunkNum() const{return chunkFirst.size();};
+    const std::vector<std::string>& getColumnNames() const{return columnNames;};
+    // 列名对应的序号, 不存在时抛出异常
+    size_t findColumn(const std::string& name) const;
+    // 第 c 列的样本 [first, first + count), 只读取重叠的块
+    std::vector<double> readColumn(size_t c, uint64_t first, uint64_t count);
+    // 时间 (第 0 列) 落在 [tBegin, tEnd] 内的样本: times 与 values 等长
+    void readWindow(size_t c, double tBegin, double tEnd, std::vector<double>& times, std::vector<double>& values);
+    // 与 [tBegin, tEnd] 重叠的各块在第 c 列上的 min/max, 不读取数据块
+    std::vector<ChunkSummary> overview(size_t c, double tBegin, double tEnd) const;
+private:
+    std::ifstream ifs;
+    size_t dimension = 0;
+    size_t chunkSize = 0;
+    uint64_t sampleNum = 0;
+    std::vector<std::string> columnNames;
+    std::vector<uint64_t> chunkFirst, chunkCount;
+    std::vector<uint64_t> offsets;      // 块数 x 分量数
+    std::vector<double> mins, maxs;
+    void readChunk(size_t chunk, size_t c, std::vector<double>& out);
+};
@@ -0,0 +1,37 @@
+#pragma once
+#include <vector>
+#include <ostream>
+#include <cstddef>
+// 逐周期的振幅与频率: 以向上过零点划分周期, 输出每个周期的起点, 周期, 峰值, 谷值和周期内 RMS.
+// 作为步进回调使用, 过零时刻, 峰谷值和周期积分均由步端点位移和速度的三次 Hermite 插值得到
+class CycleTracker{
+public:
+    // 输出以 timeScale 换算时间 (tao = f t), 以 lengthScale 无量纲化位移 (A* = y / D)
+    CycleTracker(std::ostream& os_, double timeScale_, double lengthScale_);
+    // 跟踪 state[index] - state[refIndex] (refIndex < 0 时为 state[index]), 速度分量同理
+    void addChannel(int index, int velocityIndex, int refIndex = -1, int refVelocityIndex = -1);
+    void writeHeader();
+    void update(const std::vector<double>& state);
+    size_t getCycleNum() const{return cycleNum;};
+private:
+    struct Channel{
+        int index, velocityIndex, refIndex, refVelocityIndex;
+        bool started = false;   // 已经过第一个向上过零点
+        size_t cycle = 0;
+        double cycleStart = 0.0;
+        double peak = 0.0;
+        double trough = 0.0;
+        double integral = 0.0;
+        double prevY = 0.0;
+        double prevV = 0.0;
+    };
+    std::ostream& os;
+    double timeScale;
+    double lengthScale;
+    std::vector<Channel> channels;
+    size_t sampleNum = 0;
+    size_t cycleNum = 0;
+    double prevTime = 0.0;
+    // 步内 s in [sBegin, sEnd] 一段计入当前周期
+    void accumulate(Channel& c, double y, double v, double h, double sBegin, double sEnd);
+};
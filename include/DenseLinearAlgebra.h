@@ -0,0 +1,15 @@
+#pragma once
+#include <vector>
+#include <complex>
+// 小型稠密矩阵运算, 矩阵按行存储 a[i * n + j], 不依赖外部库
+
+// 部分选主元 LU 分解 (原位), 奇异时返回 false
+bool luFactor(std::vector<double>& a, std::vector<int>& pivots, size_t n);
+// 用 luFactor 的结果原位求解 A x = b
+void luSolve(const std::vector<double>& a, const std::vector<int>& pivots, std::vector<double>& b, size_t n);
+// 一般实矩阵的全部特征值 (平衡 + Householder 约化为 Hessenberg 形 + Francis 双位移 QR), 实特征值的虚部严格为 0
+std::vector<std::complex<double>> eigenvalues(std::vector<double> a, size_t n);
+// c = a * b (n x n)
+void matrixMultiply(const std::vector<double>& a, const std::vector<double>& b, std::vector<double>& c, size_t n);
+// 矩阵指数 e^A (缩放-平方 + Taylor 级数)
+std::vector<double> matrixExponential(const std::vector<double>& a, size_t n);
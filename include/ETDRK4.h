@@ -0,0 +1,25 @@
+#pragma once
+#include "Integrator.h"
+// 指数时间差分 RK4 (Cox & Matthews 2002): y' = L y + N(y), 线性部分 L 由矩阵指数精确传播,
+// 只有 N(y) = f(y) - L y 显式处理. 各 phi 函数在积分开始前由增广矩阵的指数一次算出
+class ETDRK4 : public Integrator
+{
+
+public:
+	// linear: L, 按行存储 dim x dim
+	ETDRK4(int dim, double h, int steps, const DerivativeFunction& deriv, const std::vector<double>& linear_)
+		: Integrator(dim, h, steps, deriv), linear(linear_) {
+	}
+protected:
+	void prepare() override;
+	void step(std::vector<double>& state) override;
+private:
+	std::vector<double> linear;
+	// e^{hL}, e^{hL/2}, h/2 phi1(hL/2), h (phi1 - 3 phi2 + 4 phi3), h (phi2 - 2 phi3), h (4 phi3 - phi2)
+	std::vector<double> expFull, expHalf, phiHalf, f1, f2, f3;
+	std::vector<double> nu, na, nb, nc, a, b, c, tmp;
+	// N(y) = f(y) - L y
+	void nonlinear(const std::vector<double>& y, std::vector<double>& out);
+	// out = m * x (+ out 当 accumulate 为 true)
+	void multiply(const std::vector<double>& m, const std::vector<double>& x, std::vector<double>& out, bool accumulate = false) const;
+};
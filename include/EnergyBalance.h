@@ -0,0 +1,22 @@
+#pragma once
+#include <vector>
+#include <functional>
+#include <cstddef>
+// 各功率项在统计区间内的时间积分 (梯形公式), 作为步进回调逐步累计.
+// 功率由 powers(state, p) 给出. 积分误差为 O(h^2); 统计区间不与振动周期对齐, 平均功率
+// 另含不完整周期带来的 O(周期 / 区间长度) 偏差, 区间越长越小 (区间恰为整数个周期时才有谱精度)
+class EnergyBalance{
+public:
+    using PowerFunction = std::function<void(const std::vector<double>&, std::vector<double>&)>;
+    EnergyBalance(size_t termNum, double startTime_, const PowerFunction& powers_);
+    void update(const std::vector<double>& state);
+    const std::vector<double>& getEnergies() const{return energies;};
+    double getDuration() const{return duration;};
+private:
+    double startTime;
+    PowerFunction powers;
+    bool hasPrev = false;
+    double prevTime = 0.0;
+    double duration = 0.0;
+    std::vector<double> prevPower, power, energies;
+};
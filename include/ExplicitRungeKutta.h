@@ -0,0 +1,53 @@
+#pragma once
+#include "Integrator.h"
+#include <string>
+// 显式 Runge-Kutta 方法的 Butcher 表: k_i = f(y + h sum_j a_ij k_j), y += h sum_i b_i k_i
+// 只用于定步长积分, 嵌入式方法只取高阶解的权重
+struct ButcherTableau{
+    std::string name;
+    int stages;
+    int order;
+    std::vector<double> a;  // 严格下三角, 按行存储 stages x stages
+    std::vector<double> b;
+    std::vector<double> c;
+    // 末级即下一步的首级 (FSAL): 末行 a 等于 b 且 c = 1
+    bool isFSAL() const;
+    // Tsitouras 5(4) (2011), 7 级 (FSAL)
+    static ButcherTableau tsitouras5();
+    // Butcher (1964) 7 级六阶
+    static ButcherTableau butcher6();
+    // Cooper & Verner (1972) 11 级八阶
+    static ButcherTableau cooperVerner8();
+};
+// 由 Butcher 表驱动的显式 RK, 各级斜率在积分开始前一次分配.
+// FSAL 的表 (tsit5) 把本步末级的斜率留作下一步的首级, 每步少算一次右端项
+class ExplicitRungeKutta : public Integrator
+{
+
+public:
+	ExplicitRungeKutta(int dim, double h, int steps, const DerivativeFunction& deriv, const ButcherTableau& tableau_)
+		: Integrator(dim, h, steps, deriv), tableau(tableau_) {
+	}
+protected:
+	void prepare() override;
+	void step(std::vector<double>& state) override;
+private:
+	ButcherTableau tableau;
+	std::vector<std::vector<double>> slopes;
+	std::vector<double> tempState;
+	bool firstSameAsLast = false;
+	bool hasFirstSlope = false;
+};
+// 2N 存储的低存储 RK (Williamson 形式): dU = A_i dU + h f(U), U += B_i dU.
+// 系数为 Carpenter & Kennedy (1994) 五级四阶 RK4(3)5, 除状态外只需一个寄存器
+class LowStorageRungeKutta : public Integrator
+{
+
+public:
+	using Integrator::Integrator;
+protected:
+	void prepare() override;
+	void step(std::vector<double>& state) override;
+private:
+	std::vector<double> increment, slope;
+};
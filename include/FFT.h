@@ -0,0 +1,8 @@
+#pragma once
+#include <vector>
+#include <complex>
+// 原位基 2 FFT, 长度须为 2 的幂. 不做归一化:
+// 正变换 X_k = sum x_j e^{-2 pi i jk/n}, 逆变换 x_j = sum X_k e^{+2 pi i jk/n}
+void fft(std::vector<std::complex<double>>& data, bool inverse = false);
+// 不小于 n 的最小 2 的幂
+size_t nextPowerOfTwo(size_t n);
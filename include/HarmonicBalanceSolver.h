@@ -0,0 +1,49 @@
+#pragma once
+#include <vector>
+#include <complex>
+class NESSolver;
+struct HarmonicBalanceResult{
+    bool converged = false;
+    int iterations = 0;                 // 所有初值的 Newton 迭代总数
+    double omega = 0.0;                 // 响应圆频率 (rad/s)
+    double periodTao = 0.0;
+    double yRms = 0.0;                  // 主结构 RMS (A*)
+    double yMax = 0.0;                  // 主结构最大位移 (A*)
+    double maxFloquet = 0.0;            // 在周期解上积分变分方程得到的非平凡 Floquet 乘子最大模
+    bool stable = false;
+    // 各自由度 (主结构, NES1..N) 的 Fourier 系数 (单位 D): a0, a1, b1, ..., aH, bH
+    std::vector<std::vector<double>> coefficients;
+};
+// 谐波平衡法: 位移展开为 H 阶截断 Fourier 级数, 非线性力 (NES 立方刚度, 随 A* 变化的 H1/H4)
+// 用交替频域/时域 (AFT) 计算, Newton 迭代求 (系数, omega). 相位条件为主结构 b1 = 0.
+// 收敛后从 theta = 0 的状态积分一个周期的变分方程 (ShootingSolver::analyzeOrbit) 判断稳定性,
+// 不稳定的周期解不是实际响应
+class HarmonicBalanceSolver{
+public:
+    explicit HarmonicBalanceSolver(NESSolver& solver_);
+    void setMaxIterations(int maxIterations_){maxIterations = maxIterations_;};
+    void setTolerance(double tolerance_){tolerance = tolerance_;};
+    // 调用前需 solver.refreshAll()
+    HarmonicBalanceResult solve();
+private:
+    NESSolver& solver;
+    int maxIterations = 30;
+    double tolerance = 1e-10;
+    size_t harmonicNum;
+    size_t dofNum;          // 1 + NES 数
+    size_t sampleNum;       // AFT 时域采样点数
+    size_t coeffNum;        // 每个自由度 2H + 1
+
+    // 未知量 u 中主结构 b1 的位置存放 omega
+    size_t omegaIndex() const{return 2;};
+    // 从 u 出发的阻尼 Newton 迭代, 收敛到非静止解时返回 true
+    bool newton(std::vector<double>& u, int& iterations);
+    // 频域残差 (按 omega_n^2 D 无量纲化)
+    void residual(const std::vector<double>& u, std::vector<double>& r);
+    // 系数 -> 时域采样 (order 阶导数, 对相位 theta)
+    void synthesize(const double* coeff, int order, std::vector<double>& samples);
+
+    std::vector<std::complex<double>> spectrum;
+    std::vector<std::vector<double>> disp, vel, acc;
+    std::vector<double> state, deriv;
+};
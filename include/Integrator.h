@@ -0,0 +1,52 @@
+#pragma once
+#include <vector>
+#include <functional>
+using StepCallback = std::function<void(const std::vector<double>&)>;
+// 一次计算全部分量的右端项: deriv = f(state)
+using DerivativeFunction = std::function<void(const std::vector<double>&, std::vector<double>&)>;
+// 右端项的雅可比矩阵, 按行存储 (dimension x dimension), 原位写入
+using JacobianFunction = std::function<void(const std::vector<double>&, std::vector<double>&)>;
+// 定步长积分器基类: 负责步进循环, 每步回调和发散检查, 子类只实现单步推进
+class Integrator
+{
+
+public:
+	int dimension;
+	double stepSize;
+	int numSteps;
+	std::vector<std::function<double(const std::vector<double>&)>> functions;
+	Integrator(int dim, double h, int steps, const std::vector<std::function<double(const std::vector<double>&)>>& funcs)
+		: dimension(dim), stepSize(h), numSteps(steps), functions(funcs) {
+	}
+	Integrator(int dim, double h, int steps, const DerivativeFunction& deriv)
+		: dimension(dim), stepSize(h), numSteps(steps), derivative(deriv) {
+	}
+	virtual ~Integrator() = default;
+	void setStepFunction(const StepCallback& func) {
+		stepFunction = func;
+	}
+	// 每步检查状态量是否为有限值, 以及 |state[index]| 是否超过 bound, 一旦发散立即停止积分
+	void setDivergenceCheck(int index, double bound) {
+		divergenceIndex = index;
+		divergenceBound = bound;
+	}
+	bool isDiverged() const { return diverged; }
+	int getCompletedSteps() const { return completedSteps; }
+
+	void integrate(std::vector<double>& state);
+protected:
+	// 积分开始前分配工作数组, 步进过程中不再分配内存
+	virtual void prepare() = 0;
+	// state 原位推进一步
+	virtual void step(std::vector<double>& state) = 0;
+	// deriv = f(state)
+	void evaluate(const std::vector<double>& state, std::vector<double>& deriv);
+private:
+	StepCallback stepFunction = [](const std::vector<double>& state) { return; };
+	DerivativeFunction derivative;
+	int divergenceIndex = -1;
+	double divergenceBound = 0.0;
+	bool diverged = false;
+	int completedSteps = 0;
+	bool checkDivergence(const std::vector<double>& state) const;
+};
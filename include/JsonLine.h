@@ -0,0 +1,27 @@
+#pragma once
+#include <string>
+#include <vector>
+#include <utility>
+// 单行 JSON 的最小解析器, 用于 --serve 模式的任务描述
+class JsonValue{
+public:
+    enum class Type { Null, Bool, Number, String, Array, Object };
+    Type type = Type::Null;
+    bool boolValue = false;
+    double numberValue = 0.0;
+    std::string stringValue;
+    std::vector<JsonValue> arrayValue;
+    std::vector<std::pair<std::string, JsonValue>> objectValue;
+
+    static JsonValue parse(const std::string& text);
+    // 对象中查找键, 不存在时返回 nullptr
+    const JsonValue* find(const std::string& key) const;
+    double asNumber(const std::string& what) const;
+    bool asBool(const std::string& what) const;
+    const std::string& asString(const std::string& what) const;
+    std::vector<double> asNumberArray(const std::string& what) const;
+    std::string dump() const;
+};
+std::string jsonEscape(const std::string& s);
+// 非有限值输出为 null
+std::string jsonNumber(double value);
@@ -19,6 +19,8 @@ public:
 	ModelParameters(double U_star_);
 	double getUStar() const { return U_star; };
 	void getAeroCoeffs(double A_star, double& h1_out, double& h4_out) const;
+	// 同时给出 H1*/H4* 对 A* 的导数 (分段线性插值的斜率, 表外为 0), 用于解析雅可比矩阵
+	void getAeroCoeffsAndSlopes(double A_star, double& h1_out, double& h4_out, double& dh1_out, double& dh4_out) const;
 
 private:
 	double U_star;
@@ -0,0 +1,92 @@
+#pragma once
+/*
+ * NESFDMCore 的 C 接口, 供 Python (ctypes) / MATLAB 等在进程内直接调用.
+ *
+ * 所有输出数组由调用方分配, 每个设计占 nesfdm_results_per_design() 个结果,
+ * 顺序与 fdmnes 的输出一致 (3m3u: m1u1 m1u2 m1u3 m2u1 ... m3u3).
+ * 发散的结果 y_rms / y_max 均写为 HUGE_VAL (正无穷), diverged 为 1.
+ * 库内部每个设计仍会构造求解器并分配工作内存, nesfdm_evaluate_batch 每次调用启动一组线程;
+ * 单个设计的计算为毫秒至秒级, 这部分开销可以忽略, 但调用不是零分配的.
+ * 函数返回 0 表示成功, 失败时可用 nesfdm_last_error() 取得错误信息 (线程局部).
+ *
+ * Python 示例:
+ *   lib = ctypes.CDLL("libnesfdm.so")
+ *   s = NESFDMSettings(); lib.nesfdm_default_settings(ctypes.byref(s))
+ *   lib.nesfdm_evaluate_batch(ctypes.byref(s), designs, n, 0, y_rms, y_max, diverged, status)
+ */
+#include <stddef.h>
+
+#if defined(_WIN32) && defined(NESFDM_BUILDING_DLL)
+#define NESFDM_API __declspec(dllexport)
+#elif defined(_WIN32)
+#define NESFDM_API __declspec(dllimport)
+#else
+#define NESFDM_API __attribute__((visibility("default")))
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define NESFDM_MAX_NES 9
+
+#define NESFDM_CONFIG_SINGLE 0
+#define NESFDM_CONFIG_1M3U 1
+#define NESFDM_CONFIG_3M3U 2
+
+#define NESFDM_OK 0
+#define NESFDM_ERROR 1
+
+typedef struct NESFDMSettings {
+    int config;                     /* NESFDM_CONFIG_* */
+    double u_star;                  /* 仅 single */
+    double f_natural;               /* 仅 single */
+    double initial_a_star;
+    double total_tao;
+    double result_calc_start_tao;
+    double tao_step_size;
+    double f_design;
+    double ksi_design;
+    double ksi;
+    double divergence_a_star;
+} NESFDMSettings;
+
+typedef struct NESFDMDesign {
+    int nes_number;
+    double mr[NESFDM_MAX_NES];
+    double kr[NESFDM_MAX_NES];
+    double cr[NESFDM_MAX_NES];
+} NESFDMDesign;
+
+NESFDM_API const char* nesfdm_version(void);
+NESFDM_API const char* nesfdm_last_error(void);
+/* 与 fdmnes 命令行的默认值相同 */
+NESFDM_API void nesfdm_default_settings(NESFDMSettings* settings);
+/* 每个设计的结果个数: single 为 1, 1m3u 为 3, 3m3u 为 9 */
+NESFDM_API int nesfdm_results_per_design(const NESFDMSettings* settings);
+
+/* 计算单个设计. diverged 可为 NULL, 此时由 y_rms 是否为 HUGE_VAL 判断发散 */
+NESFDM_API int nesfdm_evaluate(
+    const NESFDMSettings* settings,
+    const NESFDMDesign* design,
+    double* y_rms,
+    double* y_max,
+    int* diverged
+);
+/* 多线程计算 count 个设计, thread_num <= 0 时使用全部核心.
+ * status[i] 为各设计的返回值 (可为 NULL), 任一设计失败时函数返回 NESFDM_ERROR,
+ * 其余设计的结果仍然有效. diverged 可为 NULL */
+NESFDM_API int nesfdm_evaluate_batch(
+    const NESFDMSettings* settings,
+    const NESFDMDesign* designs,
+    size_t count,
+    int thread_num,
+    double* y_rms,
+    double* y_max,
+    int* diverged,
+    int* status
+);
+
+#ifdef __cplusplus
+}
+#endif
@@ -11,18 +11,128 @@
 #include <algorithm>
 #define PI 	3.14159265358979323846
 bool isEQ(double a, double b);
-double getRms(const std::vector<std::vector<double>>& data, size_t index, double startTime = 0.0);
-double getMax(const std::vector<std::vector<double>>& data, size_t index, double startTime = 0.0);
+// 按位判断, 不受 -ffast-math 影响
+bool isFiniteValue(double x);
+// 统计区间内位移的频谱特征 (SpectrumAnalyzer)
+struct SpectralFeatures {
+	double dominantFrequency = 0.0;		// 主频, 以主结构固有频率为单位 (f / fn)
+	double subharmonicFraction = 0.0;	// 低于 0.7 倍主频的能量占比
+	double superharmonicFraction = 0.0;	// 高于 1.5 倍主频的能量占比
+	double modulationIndex = 0.0;		// 包络的 (max - min) / (max + min), 强调制响应接近 1
+};
+// 统计区间内的能量平衡 (EnergyBalance), 各 NES 阻尼耗散占比即靶向能量传递 (TET) 的效率
+struct EnergyMetrics {
+	bool valid = false;
+	double aeroInput = 0.0;				// 气动力平均输入功率 / (k D^2 omega), 即等效负阻尼比乘 A*^2
+	double structuralFraction = 0.0;	// 主结构阻尼耗散占总耗散的比例
+	std::vector<double> nesFractions;	// 各 NES 阻尼耗散占总耗散的比例
+	double tetRatio() const {
+		double sum = 0.0;
+		for (double f : nesFractions) {
+			sum += f;
+		}
+		return sum;
+	}
+};
+// NES 相对主结构的位移 (行程) 与立方弹簧力, 统计区间内
+struct StrokeStatistics {
+	double rms = 0.0;		// 行程 RMS (/ D)
+	double max = 0.0;		// 最大行程 max |ya - yp| (/ D)
+	double peakForce = 0.0;	// 弹簧力峰值 k |ya - yp|^3 (N)
+};
 class DisplacementResults {
 public:
 	double yRms;
 	double yMax;
+	// 积分发散 (出现非有限值或振幅超限) 时提前终止, yRms/yMax 置 0 且无意义, 只以 diverged 判断.
+	// 编译使用 -ffast-math (假定没有 inf/nan), 结果中不保存非有限值; 文本输出中写作 inf
+	bool diverged = false;
+	double divergedTao = 0.0;
+	// 线性化预判为稳定, 未积分, yRms/yMax 为衰减振动的解析值
+	bool prescreened = false;
+	// 实际给出结果的方法: time / shooting / hb / slow / linear (预判);
+	// 周期解法未收敛或周期解不稳定而改用时域积分时为 time, fallback 为 true
+	std::string method = "time";
+	bool fallback = false;
+	// 打靶法 / 谐波平衡法求得的周期 (tao) 与非平凡 Floquet 乘子最大模, 改用时域积分时保留不稳定周期解的值; 未求得时为 0
+	double periodTao = 0.0;
+	double maxFloquet = 0.0;
+	// 附加统计区间的结果, 与 NESSolver::extraCalcStartTaos 一一对应
+	std::vector<double> windowRms;
+	std::vector<double> windowMax;
+	// Poincare 截面点 (主结构速度向上过零时的状态), 按行展开, 每行为一个完整状态
+	std::vector<double> sectionPoints;
+	// 频谱特征: 主结构位移, 其后为各 NES 相对主结构的位移
+	std::vector<SpectralFeatures> spectra;
+	// 能量平衡, 只有时域积分给出
+	EnergyMetrics energy;
+	// 各 NES 的行程与弹簧力, 只有时域积分给出
+	std::vector<StrokeStatistics> strokes;
 	void print() const {
-		std::cout << std::setprecision(10) << yRms << "\t" << yMax << std::endl;
+		if (diverged) {
+			std::cout << "inf\tinf";
+			for (size_t i = 0; i < windowRms.size(); i++) {
+				std::cout << "\tinf\tinf";
+			}
+		}
+		else {
+			std::cout << std::setprecision(10) << yRms << "\t" << yMax;
+			for (size_t i = 0; i < windowRms.size(); i++) {
+				std::cout << "\t" << windowRms[i] << "\t" << windowMax[i];
+			}
+		}
+		for (const auto& f : spectra) {
+			std::cout << "\t" << f.dominantFrequency << "\t" << f.subharmonicFraction
+				<< "\t" << f.superharmonicFraction << "\t" << f.modulationIndex;
+		}
+		if (energy.valid) {
+			std::cout << "\t" << energy.aeroInput << "\t" << energy.structuralFraction;
+			for (double f : energy.nesFractions) {
+				std::cout << "\t" << f;
+			}
+		}
+		for (const auto& s : strokes) {
+			std::cout << "\t" << s.rms << "\t" << s.max << "\t" << s.peakForce;
+		}
+		std::cout << std::endl;
+		if (diverged) {
+			std::cerr << "Warning: diverged at tao = " << divergedTao << std::endl;
+		}
+		if (prescreened) {
+			std::cerr << "Note: linearly stable, decaying response computed analytically" << std::endl;
+		}
+		printMethod();
+	}
+	// 非时域方法的求解信息, 与其他提示一样写到 stderr, 不改变 stdout 的列
+	void printMethod() const {
+		if (method == "time" && !fallback) {
+			return;
+		}
+		std::cerr << "Method: " << method;
+		if (fallback) {
+			std::cerr << " (periodic solution not found or unstable, fell back to time)";
+		}
+		if (periodTao > 0.0) {
+			std::cerr << ", period " << periodTao << " tao, max |Floquet multiplier| " << maxFloquet;
+		}
+		std::cerr << std::endl;
 	}
 	void printRms() const {
+		if (diverged) {
+			std::cout << "inf" << std::endl;
+			return;
+		}
 		std::cout << std::setprecision(10) << yRms << std::endl;
 	}
 
 };
-void get_avg_max(const std::vector<DisplacementResults>& allResults, double& jYRms, double& jYMax);
\ No newline at end of file
+bool anyDiverged(const std::vector<DisplacementResults>& allResults);
+// 任一工况任一 NES 的最大行程 (/ D) 超过 limit; 没有行程统计的工况不计
+bool exceedsStroke(const std::vector<DisplacementResults>& allResults, double limit);
+// get_avg_max 与 getObjective 要求没有发散的工况 (发散时抛出异常), 调用前先用 anyDiverged 判断
+void get_avg_max(const std::vector<DisplacementResults>& allResults, double& jYRms, double& jYMax);
+// avg: 全部工况 yRms 的平均; max: 全部工况 yRms 的最大值; avg_max: 各模态最大 yRms 的平均 (get_avg_max);
+// tet: 1 - 各工况 NES 耗散占比的平均 (需要能量统计, 无能量结果的工况不计入, 全部缺失时为 1)
+enum class ObjectiveType { Avg, Max, AvgMax, Tet };
+ObjectiveType parseObjective(const std::string& name);
+double getObjective(const std::vector<DisplacementResults>& allResults, ObjectiveType type);
\ No newline at end of file
@@ -0,0 +1,36 @@
+#pragma once
+#include <vector>
+#include <string>
+#include "NESFDMUtils.h"
+// 一次完整的设计评估 (对应一次 fdmnes 命令行调用)
+struct NESJob{
+    int nesNum = 1;
+    std::vector<double> mr;
+    std::vector<double> kr;
+    std::vector<double> cr;
+    std::string config = "single";  // single 1m3u 3m3u
+    double UStar = 1.7;             // 仅 single
+    double fNatural = 1.117;        // 仅 single
+    std::string objective = "avg_max"; // 仅 3m3u
+
+    double initialAStar = 0.06;
+    double totalTao = 500;
+    double resultCalcStartTao = 250;
+    double taoStepSize = 0.001;
+    double fDesign = 1.117;
+    double ksiDesign = 0.003;
+    double ksi = 0.003;
+    double divergenceAStar = 1.0;
+    std::vector<double> extraCalcStartTaos;
+    std::string method = "time";  // time shooting hb
+    double shootingTransientTao = 50; // 仅 shooting
+    double harmonicNumber = 7;    // 仅 hb
+    bool slowFlowStart = false;
+    bool linearPrescreen = false;
+    bool spectrum = false;
+    bool energy = false;          // objective 为 tet 时总是计算
+    bool stroke = false;
+    std::string integrator = "rk4"; // rk4 ros2 rodas3 etdrk4 ck4 tsit5 butcher6 cv8
+};
+void checkJob(const NESJob& job);
+std::vector<DisplacementResults> runJob(const NESJob& job);
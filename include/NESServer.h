@@ -0,0 +1,30 @@
+#pragma once
+#include <iostream>
+#include <string>
+#include <mutex>
+#include "NESJob.h"
+#include "JsonLine.h"
+#include "ThreadPool.h"
+// 常驻批处理模式: 逐行读取 JSON 任务, 在线程池中计算, 按完成顺序输出带 id 的 JSON 结果
+//
+// 任务:  {"id": 1, "n": 1, "mr": [0.01], "kr": [0.55], "cr": [0.65], "config": "3m3u", "ctao": 500, ...}
+// 结果:  {"id": 1, "status": "ok", "yRms": [...], "yMax": [...], "diverged": [...], "objective": ...}
+//        {"id": 1, "status": "error", "message": "..."}
+// 可选键: extra_rctao, shoot_ttao, slow_start, spectrum, energy, stroke; 开启的统计量以
+//        windowRms/windowMax, spectra, energy, strokes 字段按工况给出
+// 未给出的参数使用启动 --serve 时的命令行参数作为默认值
+class NESServer{
+public:
+    NESServer(const NESJob& defaults_, unsigned int threadNum);
+    // 从输入流读取任务直到 EOF, 等待所有任务完成后返回
+    void serveStream(std::istream& is, std::ostream& os);
+    // 在本地 Unix socket 上监听, 每个连接独立读写 (仅 POSIX 平台)
+    void serveUnixSocket(const std::string& path);
+    NESJob parseJob(const JsonValue& request) const;
+private:
+    NESJob defaults;
+    ThreadPool pool;
+
+    // 计算一个任务并返回结果行 (不含换行)
+    std::string handle(const std::string& line) const;
+};
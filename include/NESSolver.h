@@ -1,5 +1,8 @@
 #pragma once
 #include <functional>
+#include <string>
+#include <memory>
+#include <limits>
 #include "ModelParameters.h"
 #include "NESFDMUtils.h"
 struct NES{
@@ -51,6 +54,29 @@ public:
     double getC() const{return damping;};
 
 
+};
+// 求解方法: 时域积分 (默认), 直接求周期解的打靶法或谐波平衡法, 以及慢变流降阶模型 (近似)
+enum class SolverMethod { TimeDomain, Shooting, HarmonicBalance, SlowFlow };
+// time / shooting / hb / slow
+SolverMethod parseSolverMethod(const std::string& name);
+// 时域积分格式: 显式 RK4 (默认), L 稳定的 Rosenbrock (解析 Jacobian, 用于刚性的 NES 配置),
+// 精确处理结构线性部分的指数积分 ETDRK4, 或由 Butcher 表驱动的高阶显式 RK 与低存储 RK
+enum class IntegratorType { RK4, Ros2, Rodas3, ETDRK4, LowStorage4, Tsit5, Butcher6, CooperVerner8 };
+// rk4 / ros2 / rodas3 / etdrk4 / ck4 / tsit5 / butcher6 / cv8
+IntegratorType parseIntegratorType(const std::string& name);
+class Integrator;
+class StateHistory;
+// 零点附近线性化 (NES 立方弹簧消失, H1/H4 取小振幅值) 的稳定性
+struct LinearStability{
+    bool stable = false;        // 0 ~ initialAStar 内各 A* 下的线性化系统都稳定
+    double growthRate = 0.0;    // 主结构振动特征值的最大实部 (1/s), 负值为衰减率
+    double frequency = 0.0;     // 对应的阻尼振动频率 (Hz)
+    double criticalAStar = 0.0; // 取得 growthRate 的 A*
+    // 按 aStarSpacing 等距的各 A* 下主结构振动特征值的实部, 用于计算衰减包络;
+    // 没有振动特征值的 A* 记为 noOscillation (有限值, 编译使用 -ffast-math)
+    static constexpr double noOscillation = std::numeric_limits<double>::lowest();
+    double aStarSpacing = 0.0025;
+    std::vector<double> growthRates;
 };
 class NESSolver{
 public:
@@ -78,11 +104,52 @@ private:
     double timeStepSize = 0.001;
     double totalTime = 500;
     double resultCalcStartTime = 250.0;
+    // 附加的统计区间起点 (tao), 与 resultCalcStartTao 在同一次积分中统计,
+    // 结果按顺序放在 DisplacementResults::windowRms / windowMax
+    std::vector<double> extraCalcStartTaos;
+
+    // 主结构振幅 A* 超过该值即判为发散
+    double divergenceAStar = 1.0;
 
     double kDesign = 0.0;
     double cDesign = 0.0;
 
     std::string outputFile = "";
+    // 非零时 outputFile 写为分块列存储的二进制时程 (ColumnarHistory), 每块含该数目的样本
+    size_t outputChunkSize = 0;
+    // 非空时时域积分输出逐周期的振幅与频率表 (CycleTracker)
+    std::string cycleOutputFile = "";
+    // 时域积分在统计区间内记录主结构速度向上过零时的状态 (DisplacementResults::sectionPoints)
+    bool poincareSection = false;
+    // 时域积分结束后对统计区间内的位移做频谱分析 (DisplacementResults::spectra)
+    bool spectralAnalysis = false;
+    // 时域积分中累计统计区间内的气动输入与各阻尼耗散 (DisplacementResults::energy)
+    bool energyMetrics = false;
+    // 时域积分中统计各 NES 的行程与弹簧力 (DisplacementResults::strokes)
+    bool strokeStatistics = false;
+    // 保存最近一次时域积分的完整时程; historyDir 非空时以该目录下的 mmap 临时文件存放
+    bool keepHistory = false;
+    std::string historyDir = "";
+    std::shared_ptr<StateHistory> history;
+    // 非空时作为初始状态 (续算), 否则从 initialAStar * D 静止释放
+    std::vector<double> initialState;
+    std::vector<double> finalState;
+
+    SolverMethod method = SolverMethod::TimeDomain;
+    IntegratorType integratorType = IntegratorType::RK4;
+    // 打靶法求初值时的预积分时长
+    double shootingTransientTao = 50.0;
+    // 谐波平衡法的截断阶数
+    unsigned int harmonicNumber = 7;
+    // 时域积分从慢变流模型预测的响应出发 (未指定 initialState 时)
+    bool slowFlowStart = false;
+    // 先做线性稳定性判断, 稳定时直接给出衰减振动的解析结果
+    bool linearPrescreen = false;
+
+    // refreshFuncs 中预计算的气动力系数
+    double ypDotFactor = 0.0;
+    double ypFactor = 0.0;
+    double invOmega = 0.0;
 public:
     
 
@@ -96,7 +163,33 @@ public:
     void setTaoStepSize(double taoStepSize_);
     void setTotalTao(double totalTao_);
     void setResultCalcStartTao(double resultCalcStartTime_);
+    void setExtraCalcStartTaos(const std::vector<double>& taos_){extraCalcStartTaos = taos_;};
     void setOutput(std::string outputFile_){outputFile = outputFile_;};
+    void setOutputChunkSize(size_t chunkSize_){outputChunkSize = chunkSize_;};
+    void setCycleOutput(std::string file_){cycleOutputFile = file_;};
+    void setPoincareSection(bool enable_){poincareSection = enable_;};
+    bool isPoincareSection() const{return poincareSection;};
+    void setSpectralAnalysis(bool enable_){spectralAnalysis = enable_;};
+    bool isSpectralAnalysis() const{return spectralAnalysis;};
+    void setEnergyMetrics(bool enable_){energyMetrics = enable_;};
+    bool isEnergyMetrics() const{return energyMetrics;};
+    void setStrokeStatistics(bool enable_){strokeStatistics = enable_;};
+    bool isStrokeStatistics() const{return strokeStatistics;};
+    void setKeepHistory(bool keep_, const std::string& dir_ = ""){keepHistory = keep_; historyDir = dir_;};
+    // 未保存时程时为空
+    std::shared_ptr<const StateHistory> getHistory() const{return history;};
+    void setDivergenceAStar(double a_);
+    void setInitialState(const std::vector<double>& state_);
+    void clearInitialState(){initialState.clear();};
+    const std::vector<double>& getFinalState() const{return finalState;};
+    void setMethod(SolverMethod method_){method = method_;};
+    SolverMethod getMethod() const{return method;};
+    void setIntegrator(IntegratorType type_){integratorType = type_;};
+    void setShootingTransientTao(double tao_){shootingTransientTao = tao_;};
+    void setHarmonicNumber(unsigned int h_);
+    void setSlowFlowStart(bool enable_){slowFlowStart = enable_;};
+    void setLinearPrescreen(bool enable_){linearPrescreen = enable_;};
+    bool isLinearPrescreen() const{return linearPrescreen;};
 
     void setNESMr(size_t i, double mr_);
     void setNESKr(size_t i, double kr_);
@@ -104,18 +197,56 @@ public:
     void printMain() const{main.print();};
 
     DisplacementResults run();
+    // 时域积分, 不受 method 影响
+    DisplacementResults runTimeDomain();
+    // 按 integratorType 构造时域积分器, 调用前需 refreshAll()
+    std::unique_ptr<Integrator> makeIntegrator(int numSteps) const;
+    // 3m3u 的 9 个工况: i = 模态序号 * 3 + U* 序号
+    static constexpr size_t caseNum3m3u = 9;
+    void setCase3m3u(size_t i);
     std::vector<DisplacementResults> runConfig3m3u();
     std::vector<DisplacementResults> runConfig1m3u();
 public:
+    // funcs 捕获了 this, 复制求解器后需调用 refreshAll() 重新绑定 (run() 会自动调用)
     std::vector<std::function<double(const std::vector<double>&)>> funcs;
 public:
     double getFD() const{return fDesign;};
+    double getTotalTao() const{return totalTao;};
+    double getTaoStepSize() const{return taoStepSize;};
+    double getResultCalcStartTao() const{return resultCalcStartTao;};
+    const std::vector<double>& getExtraCalcStartTaos() const{return extraCalcStartTaos;};
     int getNESNumber() const{return nesNumber;};
+    unsigned int getDimension() const{return dimension;};
+    double getTimeStepSize() const{return timeStepSize;};
+    double getMainFN() const{return main.getFN();};
+    double getMainFR() const{return main.getFR();};
+    double getMainD() const{return main.getD();};
+    double getShootingTransientTao() const{return shootingTransientTao;};
+    double getDivergenceAStar() const{return divergenceAStar;};
+    double getInitialAStar() const{return initialAStar;};
+    unsigned int getHarmonicNumber() const{return harmonicNumber;};
+    // 冷启动初始状态: 主结构与各 NES 位移为 initialAStar * D, 速度为 0
+    std::vector<double> getStartState() const;
+    // 状态方程右端项与解析雅可比矩阵 (按行存储, dimension x dimension), 调用前需 refreshAll()
+    void computeDerivatives(const std::vector<double>& state, std::vector<double>& deriv) const;
+    void computeJacobian(const std::vector<double>& state, std::vector<double>& jac) const;
+    // 瞬时功率: [气动力输入, 主结构阻尼耗散, NES1..N 阻尼耗散], 力与 computeDerivatives 相同
+    void computePowers(const std::vector<double>& state, std::vector<double>& powers) const;
+    // 结构的线性部分: 主结构 k, c 与 NES 阻尼 (不含气动力和 NES 立方弹簧), 按行存储
+    void computeStructuralMatrix(std::vector<double>& linear) const;
+    // 零点处的 Jacobian, 气动系数 H1/H4 取 aStar 处的值 (等效线性化)
+    void computeLinearizedJacobian(double aStar, std::vector<double>& jac) const;
+    // 调用前需 refreshAll()
+    LinearStability checkLinearStability() const;
+    // 线性稳定时的衰减响应: 包络 dA/dt = Re(lambda(A)) A 从 initialAStar 积分
+    DisplacementResults linearDecayResults(const LinearStability& linear) const;
     void refreshAll();
     void printAll() const;
 private:
     void refreshDesignValue();
     void refreshTao();
+    // 周期解与发散的结果与统计区间无关, 各附加区间取相同的值
+    DisplacementResults withWindows(DisplacementResults results) const;
     void refreshFuncs();
     void refreshNES();
     void refreshModelParameters();
@@ -1,6 +1,35 @@
 #pragma once
 #include "NESSolver.h"
+#include "ParetoFront.h"
+#include "TopKTracker.h"
 #include <string>
+#include <algorithm>
+#include <atomic>
+struct SweepConfig{
+    std::vector<double> mr;
+    std::vector<double> kr;
+    std::vector<double> cr;
+};
+// 多保真度筛选的一级: 用较短的 totalTao 和较粗的 taoStepSize (或近似的求解方法) 计算, 保留目标函数最优的 keepRatio 比例
+struct FidelityLevel{
+    double totalTao;
+    double taoStepSize;
+    double keepRatio;
+    SolverMethod method = SolverMethod::TimeDomain;
+};
+// 续算状态: 同一扫描线上前一个配置各工况的末状态和结果
+struct WarmStart{
+    bool valid = false;
+    // 距上次与冷启动对照的配置数; 对照不一致后本扫描线不再续算
+    size_t sinceCheck = 0;
+    bool disabled = false;
+    // 最近一次 evaluate: 含未经对照的续算结果 / 做了对照且一致 / 做了对照且不一致
+    bool pending = false;
+    bool checkPassed = false;
+    bool checkFailed = false;
+    std::vector<std::vector<double>> states;
+    std::vector<DisplacementResults> results;
+};
 class NESSweeper{
 public:
     NESSweeper(NESSolver& solver_, std::string sweepParamsFile_, double totalMassRatio_);
@@ -9,12 +38,49 @@ public:
     void printConfigs();
     void run();
     void setOutFile(const std::string& outFile_){outFile = outFile_;};
+    void setObjective(ObjectiveType objective_){objective = objective_;};
+    void setFidelityLevels(const std::vector<FidelityLevel>& levels_){fidelityLevels = levels_;};
+    // 非支配前沿 (yRms, yMax, 总质量比) 输出文件, 扫描过程中随时更新
+    void setParetoFile(const std::string& paretoFile_){paretoFile = paretoFile_;};
+    // 按目标函数保留最优的 k 个配置, 扫描中定期打印, 结束时写入 topKFile_ (为空则只打印)
+    void setTopK(size_t k_, const std::string& topKFile_){topKNum = k_; topKFile = topKFile_;};
+    // Poincare 截面点输出文件: 每行为扫描参数, 工况序号和截面状态
+    void setPoincareFile(const std::string& file_, bool binary_){poincareFile = file_; poincareBinary = binary_;};
+    // 行程约束: 任一工况 NES 最大行程 (/ D) 超过 limit_ 的配置视为不可行, 不进入前沿和 top-K, 筛选时排在最后
+    void setStrokeLimit(double limit_){strokeLimit = limit_;};
+    void setThreadNum(unsigned int threadNum_){threadNum = std::max(threadNum_, 1u);};
+    // 续算模式: 用扫描线上相邻配置的末状态作初值, 过渡段缩短为 calcStartTao_;
+    // 结果与相邻配置的相对差超过 tolerance_ 时退回冷启动.
+    // 续算可能停在与冷启动 (initialAStar 静止释放) 不同的吸引子上: 每 checkInterval_ 个续算配置
+    // 同时做一次冷启动对照并采用冷启动结果. 续算结果在其后的对照通过后才输出 (扫描线末尾补做一次对照),
+    // 对照相差超过 tolerance_ 时这些配置冷启动重算, 该扫描线其余配置也全部冷启动; 0 为不对照, 续算结果直接输出
+    void setWarmStart(double calcStartTao_, double tolerance_, size_t checkInterval_){
+        warmStart = true; warmCalcStartTao = calcStartTao_; warmTolerance = tolerance_; warmCheckInterval = checkInterval_;
+    };
 private:
     NESSolver& solver;
     int nesNum;
     std::string sweepParamsFile;
     double totalMassRatio;
     std::string outFile;
+    std::string paretoFile;
+    size_t topKNum = 0;
+    std::string topKFile;
+    std::string poincareFile;
+    bool poincareBinary = false;
+    double strokeLimit = std::numeric_limits<double>::max();
+    unsigned int threadNum = 1;
+    bool warmStart = false;
+    double warmCalcStartTao = 50.0;
+    double warmTolerance = 0.05;
+    size_t warmCheckInterval = 4;
+    std::atomic<size_t> warmAccepted{0};
+    std::atomic<size_t> warmRejected{0};
+    std::atomic<size_t> warmChecked{0};
+    std::atomic<size_t> warmMismatched{0};
+    std::atomic<size_t> warmRedone{0};
+    ObjectiveType objective = ObjectiveType::AvgMax;
+    std::vector<FidelityLevel> fidelityLevels;
     std::vector<std::vector<std::string>> lines;
     std::vector<std::vector<double>> mrDatas;
     std::vector<std::vector<double>> krDatas;
@@ -22,7 +88,32 @@ private:
 
     void checkParamsIntegrity();
     void readParams();
-    
+    std::vector<SweepConfig> collectConfigs() const;
+    using ResultCallback = std::function<void(size_t, const std::vector<DisplacementResults>&)>;
+    // warm 为 nullptr 时冷启动
+    std::vector<DisplacementResults> evaluate(NESSolver& s, const SweepConfig& config, WarmStart* warm);
+    // 续算结果与冷启动结果是否处于同一吸引子 (各工况 yRms 相对差不超过 warmTolerance)
+    bool sameResponse(const DisplacementResults& warm, const DisplacementResults& cold) const;
+    // 将配置划分为任务, 续算时同一扫描线为一个任务
+    std::vector<std::vector<size_t>> groupTasks(const std::vector<SweepConfig>& configs, const std::vector<size_t>& indices) const;
+    // 多线程计算 indices 中的配置, 回调在互斥锁内按完成顺序调用, 返回各配置实测耗时 (秒)
+    std::vector<double> evaluateAll(
+        const std::vector<SweepConfig>& configs,
+        const std::vector<size_t>& indices,
+        const std::vector<double>& estimatedCosts,
+        const std::string& stage,
+        const ResultCallback& onResult
+    );
+    // 短时间试算, 返回每个积分步的耗时 (秒)
+    double calibrate(const SweepConfig& config);
+    void printEstimate(size_t configNum, double secondsPerStep) const;
+    std::vector<size_t> screen(const std::vector<SweepConfig>& configs, std::vector<double>& costs);
+    std::string paramHeader() const;
+    std::string paramLabel(const SweepConfig& config) const;
+    // 与 paramHeader 各列对应的参数值
+    std::vector<double> paramValues(const SweepConfig& config) const;
+    // 未发散且满足行程约束
+    bool isFeasible(const std::vector<DisplacementResults>& result) const;
     
 
-};
\ No newline at end of file
+};
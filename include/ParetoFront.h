@@ -0,0 +1,25 @@
+#pragma once
+#include <vector>
+#include <string>
+struct ParetoPoint{
+    std::vector<double> objectives; // 均为越小越好
+    std::string label;              // 对应配置的参数 (CSV 格式)
+};
+// 在线维护的非支配解集
+class ParetoFront{
+public:
+    ParetoFront(const std::vector<std::string>& objectiveNames_, const std::string& labelHeader_);
+    // 返回 true 表示前沿发生了变化
+    bool insert(const std::vector<double>& objectives, const std::string& label);
+    // 读取已有的前沿文件并合并 (表头不一致时忽略), 用于合并不同总质量比的扫描
+    void load(const std::string& file);
+    void write(const std::string& file) const;
+    const std::vector<ParetoPoint>& getPoints() const{return points;};
+private:
+    std::vector<std::string> objectiveNames;
+    std::string labelHeader;
+    std::vector<ParetoPoint> points;
+
+    std::string header() const;
+    static bool weaklyDominates(const std::vector<double>& a, const std::vector<double>& b);
+};
@@ -0,0 +1,27 @@
+#pragma once
+#include "Integrator.h"
+#include <ostream>
+#include <string>
+// Poincare 截面采样: 记录 state[index] 向上过零 (由负变正) 时刻的完整状态.
+// 作为步进回调使用; 检测到过零时才在步两端计算右端项, 各分量用三次 Hermite 插值到过零时刻
+class PoincareSection{
+public:
+    // 只记录过零时刻不早于 startTime 的点
+    PoincareSection(int dimension_, int index_, double startTime_, const DerivativeFunction& derivative_);
+    void update(const std::vector<double>& state);
+    // 按行展开, 每行 dimension 个分量
+    const std::vector<double>& getPoints() const{return points;};
+private:
+    int dimension;
+    int index;
+    double startTime;
+    DerivativeFunction derivative;
+    bool hasPrev = false;
+    std::vector<double> prevState, prevDeriv, deriv;
+    std::vector<double> points;
+};
+// 状态分量的列名: t,yp,ya1..yaN,ypv,yav1..yavN
+std::string stateHeader(int nesNumber);
+// 每个截面点写一行: prefix 各列在前, 其后为状态. 文本为逗号分隔; 二进制为连续的 double (本机字节序)
+void writeSectionPoints(std::ostream& os, const std::vector<double>& prefix, const std::vector<double>& points,
+    size_t dimension, bool binary);
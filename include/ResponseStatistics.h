@@ -0,0 +1,40 @@
+#pragma once
+#include <vector>
+#include <cstddef>
+// 由步端点的位移 y 与速度 v 构造的三次 Hermite 插值在 s = (t - t0) / h 处的值
+double hermiteValue(double y0, double v0, double y1, double v1, double h, double s);
+// 上述插值在 s in [sBegin, sEnd] 内的最大值 (端点与内部驻点中的较大者)
+double hermitePeak(double y0, double v0, double y1, double v1, double h, double sBegin = 0.0, double sEnd = 1.0);
+// y0 < 0 <= y1 时插值在 [0, 1] 内的零点 s
+double hermiteRoot(double y0, double v0, double y1, double v1, double h);
+// 插值平方在 s in [sBegin, sEnd] 上对时间的积分 (4 点 Gauss-Legendre, 结果精确)
+double hermiteSquareIntegral(double y0, double v0, double y1, double v1, double h, double sBegin, double sEnd);
+// 时域积分的流式统计量: 作为步进回调逐步更新, 不保存时程.
+// 最大 (最小) 值在速度由正变负 (由负变正) 的步内用 Hermite 插值细化, 粗步长下不再偏低;
+// RMS 为 y^2 在 [startTime, 终止时刻] 上的时间积分平均, 每步对 Hermite 插值的平方精确积分
+class ResponseStatistics{
+public:
+    // index: 位移分量, velocityIndex: 对应的速度分量, state[0] 为时间;
+    // refIndex >= 0 时统计 state[index] - state[refIndex] (如 NES 相对主结构的位移)
+    ResponseStatistics(size_t index_, size_t velocityIndex_, double startTime_, int refIndex_ = -1, int refVelocityIndex_ = -1);
+    void update(const std::vector<double>& state);
+    double getRms() const;
+    double getMax() const;
+    double getMin() const;
+    // max |y|
+    double getAbsMax() const;
+private:
+    size_t index;
+    size_t velocityIndex;
+    int refIndex;
+    int refVelocityIndex;
+    double startTime;
+    size_t sampleNum = 0;
+    double integral = 0.0;
+    double duration = 0.0;
+    double maxValue;
+    double minValue;
+    double prevTime = 0.0;
+    double prevY = 0.0;
+    double prevV = 0.0;
+};
@@ -0,0 +1,35 @@
+#pragma once
+#include "Integrator.h"
+// Rosenbrock 方法系数 (KPP 形式, 无需在各级之间做矩阵乘法):
+// (I / (h gamma) - J) K_i = f(y + sum_j a_ij K_j) + sum_j c_ij / h K_j
+// y += sum_i m_i K_i
+struct RosenbrockTableau{
+    int stages;
+    double gamma;
+    std::vector<double> a;  // 严格下三角, 按行存储 stages x stages
+    std::vector<double> c;
+    std::vector<double> m;
+    // ROS2 (Verwer et al. 1999): 二级二阶, L 稳定, 对任意 J 保持二阶 (W 方法).
+    // 数值阻尼大: 非刚性设计在大步长下极限环会被完全衰减掉 (参考设计 dtao = 0.05 时 yRms 约 1e-12)
+    static RosenbrockTableau ros2();
+    // RODAS3 (Sandu et al. 1997): 四级三阶, L 稳定且刚性精确, 对主结构振动的数值阻尼远小于 ROS2
+    static RosenbrockTableau rodas3();
+};
+// 线性隐式的 Rosenbrock 积分器, 每步用解析 Jacobian 组装并分解一次迭代矩阵, 工作数组在积分开始前分配
+class Rosenbrock : public Integrator
+{
+
+public:
+	Rosenbrock(int dim, double h, int steps, const DerivativeFunction& deriv, const JacobianFunction& jac,
+		const RosenbrockTableau& tableau_ = RosenbrockTableau::rodas3())
+		: Integrator(dim, h, steps, deriv), jacobian(jac), tableau(tableau_) {
+	}
+protected:
+	void prepare() override;
+	void step(std::vector<double>& state) override;
+private:
+	JacobianFunction jacobian;
+	RosenbrockTableau tableau;
+	std::vector<double> matrix, stages, rhs, tempState;
+	std::vector<int> pivots;
+};
@@ -1,25 +1,16 @@
 #pragma once
-#include <vector>
-#include <functional>
-using StepCallback = std::function<void(const std::vector<double>&)>;
-class RungeKutta4
+#include "Integrator.h"
+// 经典四阶 Runge-Kutta
+class RungeKutta4 : public Integrator
 {
 
 public:
-	int dimension;
-	double stepSize;
-	int numSteps;
-	std::vector<std::function<double(const std::vector<double>&)>> functions;
-	RungeKutta4(int dim, double h, int steps, const std::vector<std::function<double(const std::vector<double>&)>>& funcs)
-		: dimension(dim), stepSize(h), numSteps(steps), functions(funcs) {
-	}
-	void setStepFunction(const StepCallback& func) {
-		stepFunction = func;
-	}
-	
-	void integrate(std::vector<double>& state);
+	using Integrator::Integrator;
+protected:
+	void prepare() override;
+	void step(std::vector<double>& state) override;
 private:
-
-	StepCallback stepFunction = [](const std::vector<double>& state) { return; };
+	// k = h * f(state)
+	void evaluateScaled(const std::vector<double>& state, std::vector<double>& k);
+	std::vector<double> k1, k2, k3, k4, tempState;
 };
-
@@ -0,0 +1,40 @@
+#pragma once
+#include <vector>
+#include <complex>
+class NESSolver;
+struct PeriodicOrbit{
+    bool converged = false;
+    int iterations = 0;
+    double periodTao = 0.0;
+    double yRms = 0.0;                  // 主结构 RMS (A*)
+    double yMax = 0.0;                  // 主结构最大位移 (A*)
+    std::vector<double> initialState;   // 周期解上 yp_dot = 0 (位移峰值) 处的状态
+    std::vector<std::complex<double>> floquetMultipliers;
+    double maxFloquet = 0.0;            // 除平凡乘子 (= 1) 外的最大模
+    bool stable = false;
+};
+// 打靶法: 以 (x0, T) 为未知量对周期 T 映射做 Newton 迭代, 相位条件为 yp_dot(0) = 0.
+// 单值矩阵由变分方程与状态方程一起用 RK4 积分得到
+class ShootingSolver{
+public:
+    explicit ShootingSolver(NESSolver& solver_);
+    void setMaxIterations(int maxIterations_){maxIterations = maxIterations_;};
+    void setTolerance(double tolerance_){tolerance = tolerance_;};
+    // 调用前需 solver.refreshAll()
+    PeriodicOrbit solve();
+    // 从 x0 积分一个周期 (秒), 由单值矩阵给出 Floquet 乘子和稳定性, 同时填写 yRms/yMax/periodTao.
+    // 也用于检查其他方法 (谐波平衡) 求得的周期解
+    void analyzeOrbit(const std::vector<double>& x0, double period, PeriodicOrbit& orbit);
+private:
+    NESSolver& solver;
+    int maxIterations = 30;
+    double tolerance = 1e-9;
+    size_t dim;
+    size_t ypvIndex;
+
+    // 由时域积分给出初值, 找不到振荡时返回 false
+    bool initialGuess(std::vector<double>& x0, double& period);
+    // 从 x0 积分一个周期, monodromy 非空时同时积分变分方程
+    void integratePeriod(const std::vector<double>& x0, double period, std::vector<double>& xT,
+        std::vector<double>* monodromy, double* yRms, double* yMax);
+};
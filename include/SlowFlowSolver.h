@@ -0,0 +1,47 @@
+#pragma once
+#include <vector>
+#include <complex>
+class NESSolver;
+struct SlowFlowResult{
+    bool fixedPoint = false;            // 找到慢变流的定常解 (周期响应)
+    bool stable = false;                // 定常解稳定
+    bool diverged = false;              // 包络积分发散
+    double divergedTao = 0.0;
+    int iterations = 0;
+    double omega = 0.0;                 // 快变频率 (rad/s)
+    double yRms = 0.0;                  // 主结构 RMS (A*)
+    double yMax = 0.0;                  // 主结构最大位移 (A*)
+    // 各自由度 (主结构, NES1..N) 的复振幅 phi = (v + i omega x) e^{-i omega t}, 单位 m/s
+    std::vector<std::complex<double>> amplitudes;
+};
+// 复变量平均法 (CX-A) 慢变流降阶模型: 每个振子化为一个慢变复振幅,
+// 快变相位上的平均用等距采样求和, 力由 NESSolver::computeDerivatives 给出.
+// 先用 Newton 求定常解 (频率作为未知量), 不存在或不稳定时 (强调制响应等) 以大步长积分慢变流
+class SlowFlowSolver{
+public:
+    explicit SlowFlowSolver(NESSolver& solver_);
+    // 调用前需 solver.refreshAll()
+    SlowFlowResult solve();
+    // 由复振幅恢复相位 0 处的完整状态, 用作时域积分的初值
+    std::vector<double> toState(const SlowFlowResult& result) const;
+private:
+    NESSolver& solver;
+    size_t dofNum;
+    double omegaN;          // 主结构圆频率, 用于无量纲化
+    double D;
+    int maxIterations = 30;
+    double tolerance = 1e-10;
+
+    // 平均后的慢变流: rate = <(a + omega^2 x) e^{-i theta}>, 复振幅按 omegaN * D 无量纲化
+    void average(const std::vector<std::complex<double>>& phi, double omega, std::vector<std::complex<double>>& rate);
+    // 定常解: 未知量 [Re phi0, omega / omegaN, Re phi1, Im phi1, ...], 主结构相位取 0
+    void fixedPointResidual(const std::vector<double>& u, std::vector<double>& r);
+    bool newton(std::vector<double>& u, int& iterations);
+    // 定常解处旋转坐标系下慢变流 Jacobian 的特征值实部 (去掉相位不变性对应的零特征值)
+    bool isStable(const std::vector<std::complex<double>>& phi, double omega);
+    void integrateEnvelope(SlowFlowResult& result);
+
+    std::vector<double> state, deriv;
+    // 三次刚度力乘 e^{-i theta} 后最高为 4 次谐波, 8 点等距采样即可精确平均
+    static constexpr size_t sampleNum = 8;
+};
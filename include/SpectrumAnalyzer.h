@@ -0,0 +1,26 @@
+#pragma once
+#include "NESFDMUtils.h"
+#include <vector>
+// 统计区间内位移的频谱分析: 作为步进回调每 stride 步采样一次 (只保存抽取后的序列),
+// 积分结束后去均值加 Hann 窗做 FFT 求功率谱, 由解析信号 (FFT 构造的 Hilbert 变换) 得到包络
+class SpectrumAnalyzer{
+public:
+    SpectrumAnalyzer(double startTime_, size_t stride_);
+    // 通道为 state[index] - state[refIndex] (refIndex < 0 时为 state[index])
+    void addChannel(int index, int refIndex = -1);
+    void reserve(size_t sampleNum);
+    void update(const std::vector<double>& state);
+    // timeScale 将时间换算为 tao, 频率以 1/tao (即 f / fn) 为单位
+    std::vector<SpectralFeatures> analyze(double timeScale) const;
+    // 每个主结构周期约 64 个采样点所需的抽取间隔
+    static size_t strideFor(double taoStepSize);
+private:
+    double startTime;
+    size_t stride;
+    size_t stepNum = 0;
+    double firstTime = 0.0;
+    double lastTime = 0.0;
+    std::vector<int> indices, refIndices;
+    std::vector<std::vector<double>> samples;
+    static SpectralFeatures features(const std::vector<double>& x, double dt);
+};
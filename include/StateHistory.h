@@ -0,0 +1,34 @@
+#pragma once
+#include <vector>
+#include <string>
+#include <cstddef>
+// 完整时程的连续存储: 按分量 (列) 存放 (structure of arrays), 容量按步数一次分配, 步进中不再分配内存.
+// backingDir 非空时数据放在该目录下的临时文件中并 mmap 映射 (超长时程不占用物理内存), 文件创建后即删除
+class StateHistory{
+public:
+    StateHistory(size_t dimension_, size_t capacity_, const std::string& backingDir = "");
+    ~StateHistory();
+    StateHistory(const StateHistory&) = delete;
+    StateHistory& operator=(const StateHistory&) = delete;
+
+    // 超出容量时抛出异常
+    void push(const std::vector<double>& state);
+    size_t size() const{return count;};
+    size_t getDimension() const{return dimension;};
+    bool isMapped() const{return mapped;};
+    // 第 c 个分量的连续序列, 长度 size(); 第 0 列为时间
+    const double* column(size_t c) const{return data + c * capacity;};
+    // 第一个时间不早于 startTime 的样本 (时间单调递增, 二分查找)
+    size_t lowerBound(double startTime) const;
+    // 第 c 列在样本 [first, size()) 上的归约
+    double rms(size_t c, size_t first = 0) const;
+    double max(size_t c, size_t first = 0) const;
+    double min(size_t c, size_t first = 0) const;
+private:
+    size_t dimension;
+    size_t capacity;
+    size_t count = 0;
+    double* data = nullptr;
+    bool mapped = false;
+    size_t mappedBytes = 0;
+};
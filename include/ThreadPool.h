@@ -0,0 +1,29 @@
+#pragma once
+#include <vector>
+#include <queue>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+// 固定线程数的任务队列
+class ThreadPool{
+public:
+    explicit ThreadPool(unsigned int threadNum);
+    ~ThreadPool();
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+    void submit(std::function<void()> task);
+    // 等待队列中所有任务完成
+    void wait();
+    unsigned int getThreadNum() const{return static_cast<unsigned int>(workers.size());};
+private:
+    std::vector<std::thread> workers;
+    std::queue<std::function<void()>> tasks;
+    std::mutex mtx;
+    std::condition_variable taskCv;
+    std::condition_variable doneCv;
+    size_t running = 0;
+    bool stopping = false;
+
+    void workerLoop();
+};
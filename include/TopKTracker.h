@@ -0,0 +1,25 @@
+#pragma once
+#include <vector>
+#include <string>
+#include <queue>
+#include <ostream>
+struct RankedConfig{
+    double objective;   // 越小越好
+    std::string label;  // 对应配置的参数 (CSV 格式)
+    bool operator<(const RankedConfig& other) const{return objective < other.objective;};
+};
+// 有界大顶堆: 堆顶为当前 K 个最优配置中最差的一个
+class TopKTracker{
+public:
+    TopKTracker(size_t k_, const std::string& labelHeader_);
+    // 返回 true 表示该配置进入了前 K 名
+    bool insert(double objective, const std::string& label);
+    std::vector<RankedConfig> sorted() const;
+    void print(std::ostream& os) const;
+    void write(const std::string& file) const;
+    size_t getK() const{return k;};
+private:
+    size_t k;
+    std::string labelHeader;
+    std::priority_queue<RankedConfig> heap;
+};
@@ -0,0 +1,213 @@
+#include "ColumnarHistory.h"
+#include <algorithm>
+#include <limits>
+#include <sstream>
+#include <stdexcept>
+namespace {
+const char headerMagic[8] = {'N', 'E', 'S', 'F', 'D', 'M', 'H', '1'};
+const char trailerMagic[8] = {'N', 'E', 'S', 'F', 'D', 'M', 'I', '1'};
+const uint32_t formatVersion = 1;
+template <typename T>
+void writeValue(std::ofstream& ofs, const T& value){
+    ofs.write(reinterpret_cast<const char*>(&value), sizeof(T));
+}
+template <typename T>
+T readValue(std::ifstream& ifs){
+    T value;
+    ifs.read(reinterpret_cast<char*>(&value), sizeof(T));
+    return value;
+}
+}
+ColumnarHistoryWriter::ColumnarHistoryWriter(const std::string& path, size_t dimension_, size_t chunkSize_, const std::string& columnNames):
+ofs(path, std::ios::binary),
+dimension(dimension_),
+chunkSize(std::max<size_t>(chunkSize_, 1)),
+buffer(dimension_ * std::max<size_t>(chunkSize_, 1)){
+    if(!ofs){
+        throw std::runtime_error("Cannot open history file \"" + path + "\".");
+    }
+    ofs.write(headerMagic, sizeof(headerMagic));
+    writeValue(ofs, formatVersion);
+    writeValue(ofs, static_cast<uint32_t>(dimension));
+    writeValue(ofs, static_cast<uint64_t>(chunkSize));
+    writeValue(ofs, static_cast<uint32_t>(columnNames.size()));
+    ofs.write(columnNames.data(), columnNames.size());
+}
+ColumnarHistoryWriter::~ColumnarHistoryWriter(){
+    try{
+        close();
+    }
+    catch(...){
+    }
+}
+void ColumnarHistoryWriter::update(const std::vector<double>& state){
+    for(size_t c = 0; c < dimension; c++){
+        buffer[c * chunkSize + buffered] = state[c];
+    }
+    buffered++;
+    sampleNum++;
+    if(buffered == chunkSize){
+        flush();
+    }
+}
+void ColumnarHistoryWriter::flush(){
+    if(buffered == 0){
+        return;
+    }
+    chunkFirst.push_back(sampleNum - buffered);
+    chunkCount.push_back(buffered);
+    for(size_t c = 0; c < dimension; c++){
+        const double* x = buffer.data() + c * chunkSize;
+        ColumnIndex entry;
+        entry.offset = static_cast<uint64_t>(ofs.tellp());
+        entry.min = *std::min_element(x, x + buffered);
+        entry.max = *std::max_element(x, x + buffered);
+        index.push_back(entry);
+        ofs.write(reinterpret_cast<const char*>(x), buffered * sizeof(double));
+    }
+    buffered = 0;
+}
+void ColumnarHistoryWriter::close(){
+    if(!ofs.is_open()){
+        return;
+    }
+    flush();
+    const uint64_t indexOffset = static_cast<uint64_t>(ofs.tellp());
+    for(size_t k = 0; k < chunkFirst.size(); k++){
+        writeValue(ofs, chunkFirst[k]);
+        writeValue(ofs, chunkCount[k]);
+        for(size_t c = 0; c < dimension; c++){
+            const ColumnIndex& entry = index[k * dimension + c];
+            writeValue(ofs, entry.offset);
+            writeValue(ofs, entry.min);
+            writeValue(ofs, entry.max);
+        }
+    }
+    writeValue(ofs, static_cast<uint64_t>(chunkFirst.size()));
+    writeValue(ofs, sampleNum);
+    writeValue(ofs, indexOffset);
+    ofs.write(trailerMagic, sizeof(trailerMagic));
+    ofs.close();
+    if(ofs.fail()){
+        throw std::runtime_error("Failed to write history file.");
+    }
+}
+
+ColumnarHistoryReader::ColumnarHistoryReader(const std::string& path):
+ifs(path, std::ios::binary){
+    if(!ifs){
+        throw std::runtime_error("Cannot open history file \"" + path + "\".");
+    }
+    char magic[8];
+    ifs.read(magic, sizeof(magic));
+    if(!ifs || !std::equal(magic, magic + 8, headerMagic)){
+        throw std::runtime_error("\"" + path + "\" is not a columnar history file.");
+    }
+    if(readValue<uint32_t>(ifs) != formatVersion){
+        throw std::runtime_error("Unsupported history file version.");
+    }
+    dimension = readValue<uint32_t>(ifs);
+    chunkSize = static_cast<size_t>(readValue<uint64_t>(ifs));
+    std::string names(readValue<uint32_t>(ifs), '\0');
+    ifs.read(&names[0], names.size());
+    std::istringstream iss(names);
+    std::string name;
+    while(std::getline(iss, name, ',')){
+        columnNames.push_back(name);
+    }
+
+    const std::streamoff trailerSize = 3 * sizeof(uint64_t) + sizeof(trailerMagic);
+    ifs.seekg(-trailerSize, std::ios::end);
+    const uint64_t chunkNum = readValue<uint64_t>(ifs);
+    sampleNum = readValue<uint64_t>(ifs);
+    const uint64_t indexOffset = readValue<uint64_t>(ifs);
+    ifs.read(magic, sizeof(magic));
+    if(!ifs || !std::equal(magic, magic + 8, trailerMagic)){
+        throw std::runtime_error("History file \"" + path + "\" is truncated (no index).");
+    }
+    ifs.seekg(static_cast<std::streamoff>(indexOffset));
+    chunkFirst.resize(chunkNum);
+    chunkCount.resize(chunkNum);
+    offsets.resize(chunkNum * dimension);
+    mins.resize(chunkNum * dimension);
+    maxs.resize(chunkNum * dimension);
+    for(size_t k = 0; k < chunkNum; k++){
+        chunkFirst[k] = readValue<uint64_t>(ifs);
+        chunkCount[k] = readValue<uint64_t>(ifs);
+        for(size_t c = 0; c < dimension; c++){
+            offsets[k * dimension + c] = readValue<uint64_t>(ifs);
+            mins[k * dimension + c] = readValue<double>(ifs);
+            maxs[k * dimension + c] = readValue<double>(ifs);
+        }
+    }
+    if(!ifs){
+        throw std::runtime_error("History file \"" + path + "\" has a corrupted index.");
+    }
+}
+size_t ColumnarHistoryReader::findColumn(const std::string& name) const{
+    for(size_t c = 0; c < columnNames.size(); c++){
+        if(columnNames[c] == name){
+            return c;
+        }
+    }
+    throw std::runtime_error("No column \"" + name + "\" in history file.");
+}
+void ColumnarHistoryReader::readChunk(size_t chunk, size_t c, std::vector<double>& out){
+    out.resize(chunkCount[chunk]);
+    ifs.seekg(static_cast<std::streamoff>(offsets[chunk * dimension + c]));
+    ifs.read(reinterpret_cast<char*>(out.data()), out.size() * sizeof(double));
+    if(!ifs){
+        throw std::runtime_error("Failed to read history chunk.");
+    }
+}
+std::vector<double> ColumnarHistoryReader::readColumn(size_t c, uint64_t first, uint64_t count){
+    if(c >= dimension){
+        throw std::runtime_error("Column index of history file is out of range.");
+    }
+    std::vector<double> result;
+    const uint64_t last = std::min(first + count, sampleNum);
+    std::vector<double> chunk;
+    for(size_t k = first / chunkSize; k < chunkFirst.size() && chunkFirst[k] < last; k++){
+        readChunk(k, c, chunk);
+        const uint64_t begin = std::max(first, chunkFirst[k]) - chunkFirst[k];
+        const uint64_t end = std::min(last, chunkFirst[k] + chunkCount[k]) - chunkFirst[k];
+        result.insert(result.end(), chunk.begin() + begin, chunk.begin() + end);
+    }
+    return result;
+}
+void ColumnarHistoryReader::readWindow(size_t c, double tBegin, double tEnd, std::vector<double>& times, std::vector<double>& values){
+    if(c >= dimension){
+        throw std::runtime_error("Column index of history file is out of range.");
+    }
+    times.clear();
+    values.clear();
+    std::vector<double> t, x;
+    for(size_t k = 0; k < chunkFirst.size(); k++){
+        // 时间列单调递增, 块的 min/max 即其时间范围
+        if(maxs[k * dimension] < tBegin || mins[k * dimension] > tEnd){
+            continue;
+        }
+        readChunk(k, 0, t);
+        readChunk(k, c, x);
+        for(size_t i = 0; i < t.size(); i++){
+            if(t[i] >= tBegin && t[i] <= tEnd){
+                times.push_back(t[i]);
+                values.push_back(x[i]);
+            }
+        }
+    }
+}
+std::vector<ColumnarHistoryReader::ChunkSummary> ColumnarHistoryReader::overview(size_t c, double tBegin, double tEnd) const{
+    if(c >= dimension){
+        throw std::runtime_error("Column index of history file is out of range.");
+    }
+    std::vector<ChunkSummary> result;
+    for(size_t k = 0; k < chunkFirst.size(); k++){
+        const double t0 = mins[k * dimension], t1 = maxs[k * dimension];
+        if(t1 < tBegin || t0 > tEnd){
+            continue;
+        }
+        result.push_back({ t0, t1, mins[k * dimension + c], maxs[k * dimension + c] });
+    }
+    return result;
+}
@@ -0,0 +1,67 @@
+#include "CycleTracker.h"
+#include "ResponseStatistics.h"
+#include <cmath>
+#include <algorithm>
+CycleTracker::CycleTracker(std::ostream& os_, double timeScale_, double lengthScale_):
+os(os_),
+timeScale(timeScale_),
+lengthScale(lengthScale_){
+}
+void CycleTracker::addChannel(int index, int velocityIndex, int refIndex, int refVelocityIndex){
+    Channel c;
+    c.index = index;
+    c.velocityIndex = velocityIndex;
+    c.refIndex = refIndex;
+    c.refVelocityIndex = refVelocityIndex;
+    channels.push_back(c);
+}
+void CycleTracker::writeHeader(){
+    // channel 0 为主结构, i 为第 i 个 NES 相对主结构的位移
+    os << "channel,cycle,startTao,period,peak,trough,rms" << "\n";
+}
+void CycleTracker::accumulate(Channel& c, double y, double v, double h, double sBegin, double sEnd){
+    c.peak = std::max(c.peak, hermitePeak(c.prevY, c.prevV, y, v, h, sBegin, sEnd));
+    c.trough = std::min(c.trough, -hermitePeak(-c.prevY, -c.prevV, -y, -v, h, sBegin, sEnd));
+    c.integral += hermiteSquareIntegral(c.prevY, c.prevV, y, v, h, sBegin, sEnd);
+}
+void CycleTracker::update(const std::vector<double>& state){
+    const double t = state[0];
+    const double h = t - prevTime;
+    for(size_t i = 0; i < channels.size(); i++){
+        Channel& c = channels[i];
+        double y = state[c.index];
+        double v = state[c.velocityIndex];
+        if(c.refIndex >= 0){
+            y -= state[c.refIndex];
+            v -= state[c.refVelocityIndex];
+        }
+        if(sampleNum > 0){
+            if(c.prevY < 0.0 && y >= 0.0){
+                double s = hermiteRoot(c.prevY, c.prevV, y, v, h);
+                double crossing = prevTime + s * h;
+                if(c.started){
+                    accumulate(c, y, v, h, 0.0, s);
+                    double period = crossing - c.cycleStart;
+                    os << i << "," << c.cycle << "," << c.cycleStart * timeScale << "," << period * timeScale << ","
+                    << c.peak / lengthScale << "," << c.trough / lengthScale << ","
+                    << std::sqrt(c.integral / period) / lengthScale << "\n";
+                    c.cycle++;
+                    cycleNum++;
+                }
+                c.started = true;
+                c.cycleStart = crossing;
+                c.peak = 0.0;
+                c.trough = 0.0;
+                c.integral = 0.0;
+                accumulate(c, y, v, h, s, 1.0);
+            }
+            else if(c.started){
+                accumulate(c, y, v, h, 0.0, 1.0);
+            }
+        }
+        c.prevY = y;
+        c.prevV = v;
+    }
+    prevTime = t;
+    sampleNum++;
+}
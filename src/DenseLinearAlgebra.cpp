@@ -0,0 +1,354 @@
+#include "DenseLinearAlgebra.h"
+#include <cmath>
+#include <limits>
+#include <stdexcept>
+#include <algorithm>
+bool luFactor(std::vector<double>& a, std::vector<int>& pivots, size_t n){
+    pivots.resize(n);
+    for(size_t k = 0; k < n; k++){
+        size_t p = k;
+        double maxVal = std::abs(a[k * n + k]);
+        for(size_t i = k + 1; i < n; i++){
+            if(std::abs(a[i * n + k]) > maxVal){
+                maxVal = std::abs(a[i * n + k]);
+                p = i;
+            }
+        }
+        pivots[k] = static_cast<int>(p);
+        if(maxVal == 0.0){
+            return false;
+        }
+        if(p != k){
+            for(size_t j = 0; j < n; j++){
+                std::swap(a[k * n + j], a[p * n + j]);
+            }
+        }
+        double invPivot = 1.0 / a[k * n + k];
+        for(size_t i = k + 1; i < n; i++){
+            double factor = a[i * n + k] * invPivot;
+            a[i * n + k] = factor;
+            for(size_t j = k + 1; j < n; j++){
+                a[i * n + j] -= factor * a[k * n + j];
+            }
+        }
+    }
+    return true;
+}
+void luSolve(const std::vector<double>& a, const std::vector<int>& pivots, std::vector<double>& b, size_t n){
+    for(size_t k = 0; k < n; k++){
+        size_t p = static_cast<size_t>(pivots[k]);
+        if(p != k){
+            std::swap(b[k], b[p]);
+        }
+    }
+    for(size_t i = 1; i < n; i++){
+        double sum = b[i];
+        for(size_t j = 0; j < i; j++){
+            sum -= a[i * n + j] * b[j];
+        }
+        b[i] = sum;
+    }
+    for(size_t i = n; i-- > 0;){
+        double sum = b[i];
+        for(size_t j = i + 1; j < n; j++){
+            sum -= a[i * n + j] * b[j];
+        }
+        b[i] = sum / a[i * n + i];
+    }
+}
+// 收敛判断使用显式的相对容差, 不依赖 (x + s == s) 这类在 -ffast-math 下可能被化简的写法
+static bool negligible(double x, double scale){
+    return std::abs(x) <= std::numeric_limits<double>::epsilon() * scale;
+}
+// 以 2 的整数次幂做对角相似变换, 使各行与对应列的非对角 1-范数接近, 减小特征值的舍入误差
+// (思路同 LAPACK dgebal, 比例因子为 2 的幂时变换不引入舍入)
+static void balance(std::vector<double>& a, size_t n){
+    for(int sweep = 0; sweep < 64; sweep++){
+        bool changed = false;
+        for(size_t i = 0; i < n; i++){
+            double rowNorm = 0.0, colNorm = 0.0;
+            for(size_t j = 0; j < n; j++){
+                if(j != i){
+                    rowNorm += std::abs(a[i * n + j]);
+                    colNorm += std::abs(a[j * n + i]);
+                }
+            }
+            if(rowNorm == 0.0 || colNorm == 0.0){
+                continue;
+            }
+            // 使 colNorm * f 与 rowNorm / f 相等的 f 取最接近的 2 的幂
+            const int e = static_cast<int>(std::lround(0.5 * std::log2(rowNorm / colNorm)));
+            if(e == 0){
+                continue;
+            }
+            const double f = std::ldexp(1.0, e);
+            // 收益不明显时不做, 保证迭代终止
+            if(colNorm * f + rowNorm / f >= 0.95 * (colNorm + rowNorm)){
+                continue;
+            }
+            for(size_t j = 0; j < n; j++){
+                a[i * n + j] /= f;
+                a[j * n + i] *= f;
+            }
+            changed = true;
+        }
+        if(!changed){
+            break;
+        }
+    }
+}
+// Householder 变换约化为上 Hessenberg 矩阵 (Golub & Van Loan, Matrix Computations, 7.4.3)
+static void reduceToHessenberg(std::vector<double>& a, size_t n){
+    std::vector<double> v(n);
+    for(size_t k = 0; k + 2 < n; k++){
+        // 消去第 k 列中 k + 1 行以下的元素: P = I - beta v v^T 作用于第 k + 1 ~ n - 1 行/列
+        double norm = 0.0;
+        for(size_t i = k + 1; i < n; i++){
+            norm = std::max(norm, std::abs(a[i * n + k]));
+        }
+        if(norm == 0.0){
+            continue;
+        }
+        double sumSq = 0.0;
+        for(size_t i = k + 1; i < n; i++){
+            v[i] = a[i * n + k] / norm;
+            sumSq += v[i] * v[i];
+        }
+        const double alpha = v[k + 1] >= 0.0 ? -std::sqrt(sumSq) : std::sqrt(sumSq);
+        v[k + 1] -= alpha;
+        const double vv = sumSq - 2.0 * alpha * (v[k + 1] + alpha) + alpha * alpha;
+        if(vv == 0.0){
+            continue;
+        }
+        const double beta = 2.0 / vv;
+        // 左乘: 第 k + 1 ~ n - 1 行
+        for(size_t j = k; j < n; j++){
+            double dot = 0.0;
+            for(size_t i = k + 1; i < n; i++){
+                dot += v[i] * a[i * n + j];
+            }
+            dot *= beta;
+            for(size_t i = k + 1; i < n; i++){
+                a[i * n + j] -= dot * v[i];
+            }
+        }
+        // 右乘: 第 k + 1 ~ n - 1 列
+        for(size_t i = 0; i < n; i++){
+            double dot = 0.0;
+            for(size_t j = k + 1; j < n; j++){
+                dot += a[i * n + j] * v[j];
+            }
+            dot *= beta;
+            for(size_t j = k + 1; j < n; j++){
+                a[i * n + j] -= dot * v[j];
+            }
+        }
+        for(size_t i = k + 2; i < n; i++){
+            a[i * n + k] = 0.0;
+        }
+    }
+}
+// 2 x 2 块 [p q; r s] 的特征值
+static void eigenvalues2x2(double p, double q, double r, double s, std::complex<double>& e1, std::complex<double>& e2){
+    const double mean = 0.5 * (p + s);
+    const double half = 0.5 * (p - s);
+    const double disc = half * half + q * r;
+    if(disc < 0.0){
+        const double im = std::sqrt(-disc);
+        e1 = std::complex<double>(mean, im);
+        e2 = std::complex<double>(mean, -im);
+        return;
+    }
+    // 实根: 先取与 half 同号的较大根, 另一根由乘积得到, 避免相减抵消
+    const double root = std::sqrt(disc);
+    const double big = half >= 0.0 ? half + root : half - root;
+    e1 = s + big;
+    e2 = big != 0.0 ? s - q * r / big : s;
+}
+// 对 n 维向量 x (n = 2 或 3) 构造 Householder 反射 I - beta v v^T, 使其把 x 映射到第一个坐标轴
+static double householder(const double* x, int len, double* v){
+    double norm = 0.0;
+    for(int i = 0; i < len; i++){
+        norm += x[i] * x[i];
+        v[i] = x[i];
+    }
+    norm = std::sqrt(norm);
+    if(norm == 0.0){
+        return 0.0;
+    }
+    v[0] += x[0] >= 0.0 ? norm : -norm;
+    double vv = 0.0;
+    for(int i = 0; i < len; i++){
+        vv += v[i] * v[i];
+    }
+    return 2.0 / vv;
+}
+// 上 Hessenberg 矩阵的 Francis 双位移隐式 QR (Golub & Van Loan, Matrix Computations, 7.5.5),
+// 只求特征值, 反射只作用于当前未收敛的对角块
+static std::vector<std::complex<double>> hessenbergQR(std::vector<double>& a, size_t n){
+    auto H = [&a, n](size_t i, size_t j) -> double& { return a[i * n + j]; };
+    double matrixNorm = 0.0;
+    for(size_t i = 0; i < n * n; i++){
+        matrixNorm = std::max(matrixNorm, std::abs(a[i]));
+    }
+    std::vector<std::complex<double>> values(n);
+    const int maxIterations = 100;
+    int iterations = 0;
+    size_t hi = n - 1;
+    while(true){
+        // 寻找活动块 [lo, hi]: lo 处的次对角元可忽略
+        size_t lo = hi;
+        while(lo > 0){
+            double scale = std::abs(H(lo - 1, lo - 1)) + std::abs(H(lo, lo));
+            if(negligible(H(lo, lo - 1), scale == 0.0 ? matrixNorm : scale)){
+                H(lo, lo - 1) = 0.0;
+                break;
+            }
+            lo--;
+        }
+        if(lo == hi){
+            values[hi] = H(hi, hi);
+            iterations = 0;
+            if(hi == 0){
+                break;
+            }
+            hi--;
+            continue;
+        }
+        if(lo + 1 == hi){
+            eigenvalues2x2(H(lo, lo), H(lo, hi), H(hi, lo), H(hi, hi), values[lo], values[hi]);
+            iterations = 0;
+            if(lo == 0){
+                break;
+            }
+            hi = lo - 1;
+            continue;
+        }
+        if(++iterations > maxIterations){
+            throw std::runtime_error("Eigenvalue iteration does not converge.");
+        }
+        // 位移取右下 2 x 2 块的两个特征值 (以和 sum 与积 prod 给出);
+        // 长期不收敛时换用由次对角元大小构造的一对复位移打破循环
+        double sum, prod;
+        if(iterations % 10 == 0){
+            const double e = std::abs(H(hi, hi - 1)) + std::abs(H(hi - 1, hi - 2));
+            const double re = H(hi, hi) + 0.6 * e;
+            const double im = 0.8 * e;
+            sum = 2.0 * re;
+            prod = re * re + im * im;
+        }
+        else{
+            sum = H(hi - 1, hi - 1) + H(hi, hi);
+            prod = H(hi - 1, hi - 1) * H(hi, hi) - H(hi - 1, hi) * H(hi, hi - 1);
+        }
+        // (H - s1)(H - s2) e1 的前三个分量
+        double x[3];
+        x[0] = H(lo, lo) * H(lo, lo) + H(lo, lo + 1) * H(lo + 1, lo) - sum * H(lo, lo) + prod;
+        x[1] = H(lo + 1, lo) * (H(lo, lo) + H(lo + 1, lo + 1) - sum);
+        x[2] = H(lo + 1, lo) * H(lo + 2, lo + 1);
+        // 逐列追赶凸起, 恢复 Hessenberg 形式
+        for(size_t k = lo; k + 1 <= hi; k++){
+            const int len = k + 2 <= hi ? 3 : 2;
+            double v[3];
+            const double beta = householder(x, len, v);
+            if(beta != 0.0){
+                const size_t firstCol = k > lo ? k - 1 : lo;
+                for(size_t j = firstCol; j <= hi; j++){
+                    double dot = 0.0;
+                    for(int i = 0; i < len; i++){
+                        dot += v[i] * H(k + i, j);
+                    }
+                    dot *= beta;
+                    for(int i = 0; i < len; i++){
+                        H(k + i, j) -= dot * v[i];
+                    }
+                }
+                const size_t lastRow = std::min(k + 3, hi);
+                for(size_t i = lo; i <= lastRow; i++){
+                    double dot = 0.0;
+                    for(int j = 0; j < len; j++){
+                        dot += H(i, k + j) * v[j];
+                    }
+                    dot *= beta;
+                    for(int j = 0; j < len; j++){
+                        H(i, k + j) -= dot * v[j];
+                    }
+                }
+                if(k > lo){
+                    for(int i = 1; i < len; i++){
+                        H(k + i, k - 1) = 0.0;
+                    }
+                }
+            }
+            if(k + 1 < hi){
+                x[0] = H(k + 1, k);
+                x[1] = H(k + 2, k);
+                x[2] = k + 3 <= hi ? H(k + 3, k) : 0.0;
+            }
+        }
+    }
+    return values;
+}
+std::vector<std::complex<double>> eigenvalues(std::vector<double> a, size_t n){
+    if(a.size() != n * n){
+        throw std::runtime_error("Matrix size does not match in eigenvalues().");
+    }
+    if(n == 0){
+        return {};
+    }
+    balance(a, n);
+    reduceToHessenberg(a, n);
+    return hessenbergQR(a, n);
+}
+void matrixMultiply(const std::vector<double>& a, const std::vector<double>& b, std::vector<double>& c, size_t n){
+    c.assign(n * n, 0.0);
+    for(size_t i = 0; i < n; i++){
+        for(size_t k = 0; k < n; k++){
+            const double aik = a[i * n + k];
+            if(aik == 0.0){
+                continue;
+            }
+            for(size_t j = 0; j < n; j++){
+                c[i * n + j] += aik * b[k * n + j];
+            }
+        }
+    }
+}
+std::vector<double> matrixExponential(const std::vector<double>& a, size_t n){
+    // 缩放到 1-范数不超过 0.5, Taylor 级数取到 18 阶 (截断误差 < 1e-22), 再平方回去
+    double norm = 0.0;
+    for(size_t j = 0; j < n; j++){
+        double colSum = 0.0;
+        for(size_t i = 0; i < n; i++){
+            colSum += std::abs(a[i * n + j]);
+        }
+        norm = std::max(norm, colSum);
+    }
+    int squarings = 0;
+    double scale = 1.0;
+    while(norm * scale > 0.5){
+        scale *= 0.5;
+        squarings++;
+    }
+    std::vector<double> scaled(a), term(n * n, 0.0), result(n * n, 0.0), next;
+    for(double& x : scaled){
+        x *= scale;
+    }
+    for(size_t i = 0; i < n; i++){
+        term[i * n + i] = 1.0;
+        result[i * n + i] = 1.0;
+    }
+    for(int k = 1; k <= 18; k++){
+        matrixMultiply(term, scaled, next, n);
+        term.swap(next);
+        for(size_t i = 0; i < n * n; i++){
+            term[i] /= k;
+            result[i] += term[i];
+        }
+    }
+    for(int s = 0; s < squarings; s++){
+        matrixMultiply(result, result, next, n);
+        result.swap(next);
+    }
+    return result;
+}
@@ -0,0 +1,99 @@
+#include "ETDRK4.h"
+#include "DenseLinearAlgebra.h"
+#include <algorithm>
+namespace {
+// phi_1..phi_3(tau L) * tau: 增广矩阵 [[tau L, tau I, 0, 0], [0, 0, I, 0], [0, 0, 0, I], [0, 0, 0, 0]]
+// 的指数第一行块依次为 e^{tau L}, tau phi1, tau phi2, tau phi3 (Higham 2008, Thm 10.2 的变形)
+void phiFunctions(const std::vector<double>& linear, size_t n, double tau,
+	std::vector<double>& e, std::vector<double>& phi1, std::vector<double>& phi2, std::vector<double>& phi3) {
+	const size_t m = 4 * n;
+	std::vector<double> aug(m * m, 0.0);
+	for (size_t i = 0; i < n; ++i) {
+		for (size_t j = 0; j < n; ++j) {
+			aug[i * m + j] = tau * linear[i * n + j];
+		}
+		aug[i * m + n + i] = tau;
+		aug[(n + i) * m + 2 * n + i] = 1.0;
+		aug[(2 * n + i) * m + 3 * n + i] = 1.0;
+	}
+	std::vector<double> ex = matrixExponential(aug, m);
+	e.resize(n * n);
+	phi1.resize(n * n);
+	phi2.resize(n * n);
+	phi3.resize(n * n);
+	for (size_t i = 0; i < n; ++i) {
+		for (size_t j = 0; j < n; ++j) {
+			e[i * n + j] = ex[i * m + j];
+			phi1[i * n + j] = ex[i * m + n + j];
+			phi2[i * n + j] = ex[i * m + 2 * n + j];
+			phi3[i * n + j] = ex[i * m + 3 * n + j];
+		}
+	}
+}
+}
+void ETDRK4::prepare() {
+	const size_t n = static_cast<size_t>(dimension);
+	std::vector<double> p1, p2, p3, unused;
+	phiFunctions(linear, n, stepSize, expFull, p1, p2, p3);
+	phiFunctions(linear, n, 0.5 * stepSize, expHalf, phiHalf, unused, unused);
+	f1.resize(n * n);
+	f2.resize(n * n);
+	f3.resize(n * n);
+	for (size_t i = 0; i < n * n; ++i) {
+		f1[i] = p1[i] - 3.0 * p2[i] + 4.0 * p3[i];
+		f2[i] = p2[i] - 2.0 * p3[i];
+		f3[i] = 4.0 * p3[i] - p2[i];
+	}
+	for (auto* v : {&nu, &na, &nb, &nc, &a, &b, &c, &tmp}) {
+		v->resize(n);
+	}
+}
+void ETDRK4::multiply(const std::vector<double>& m, const std::vector<double>& x, std::vector<double>& out, bool accumulate) const {
+	const size_t n = static_cast<size_t>(dimension);
+	for (size_t i = 0; i < n; ++i) {
+		double sum = accumulate ? out[i] : 0.0;
+		for (size_t j = 0; j < n; ++j) {
+			sum += m[i * n + j] * x[j];
+		}
+		out[i] = sum;
+	}
+}
+void ETDRK4::nonlinear(const std::vector<double>& y, std::vector<double>& out) {
+	evaluate(y, out);
+	const size_t n = static_cast<size_t>(dimension);
+	for (size_t i = 0; i < n; ++i) {
+		double sum = 0.0;
+		for (size_t j = 0; j < n; ++j) {
+			sum += linear[i * n + j] * y[j];
+		}
+		out[i] -= sum;
+	}
+}
+void ETDRK4::step(std::vector<double>& state) {
+	const size_t n = static_cast<size_t>(dimension);
+	// a = e^{hL/2} u + h/2 phi1 N(u)
+	nonlinear(state, nu);
+	multiply(expHalf, state, a);
+	multiply(phiHalf, nu, a, true);
+	// b = e^{hL/2} u + h/2 phi1 N(a)
+	nonlinear(a, na);
+	multiply(expHalf, state, b);
+	multiply(phiHalf, na, b, true);
+	// c = e^{hL/2} a + h/2 phi1 (2 N(b) - N(u))
+	nonlinear(b, nb);
+	for (size_t i = 0; i < n; ++i) {
+		tmp[i] = 2.0 * nb[i] - nu[i];
+	}
+	multiply(expHalf, a, c);
+	multiply(phiHalf, tmp, c, true);
+	nonlinear(c, nc);
+	// u = e^{hL} u + f1 N(u) + 2 f2 (N(a) + N(b)) + f3 N(c)
+	for (size_t i = 0; i < n; ++i) {
+		tmp[i] = 2.0 * (na[i] + nb[i]);
+	}
+	multiply(expFull, state, a);
+	multiply(f1, nu, a, true);
+	multiply(f2, tmp, a, true);
+	multiply(f3, nc, a, true);
+	std::copy(a.begin(), a.end(), state.begin());
+}
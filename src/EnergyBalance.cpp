@@ -0,0 +1,26 @@
+#include "EnergyBalance.h"
+EnergyBalance::EnergyBalance(size_t termNum, double startTime_, const PowerFunction& powers_):
+startTime(startTime_),
+powers(powers_),
+prevPower(termNum, 0.0),
+power(termNum, 0.0),
+energies(termNum, 0.0){
+}
+void EnergyBalance::update(const std::vector<double>& state){
+    const double t = state[0];
+    // 从统计区间内的第一个样本开始积分, 平均功率按实际积分时长计算
+    if(t < startTime){
+        return;
+    }
+    powers(state, power);
+    if(hasPrev){
+        const double width = t - prevTime;
+        for(size_t i = 0; i < power.size(); i++){
+            energies[i] += 0.5 * width * (prevPower[i] + power[i]);
+        }
+        duration += width;
+    }
+    prevTime = t;
+    prevPower.swap(power);
+    hasPrev = true;
+}
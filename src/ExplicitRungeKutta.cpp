@@ -0,0 +1,146 @@
+#include "ExplicitRungeKutta.h"
+#include <cmath>
+namespace {
+// 由按行给出的下三角系数构造 stages x stages 的 a
+std::vector<double> lowerTriangle(int stages, const std::vector<std::vector<double>>& rows){
+    std::vector<double> a(stages * stages, 0.0);
+    for(int i = 1; i < stages; i++){
+        for(size_t j = 0; j < rows[i - 1].size(); j++){
+            a[i * stages + j] = rows[i - 1][j];
+        }
+    }
+    return a;
+}
+}
+ButcherTableau ButcherTableau::tsitouras5(){
+    ButcherTableau t;
+    t.name = "tsit5";
+    t.stages = 7;
+    t.order = 5;
+    t.a = lowerTriangle(7, {
+        {0.161},
+        {-0.008480655492356989, 0.335480655492357},
+        {2.897153057105493, -6.359448489975075, 4.3622954328695815},
+        {5.325864828439257, -11.748883564062828, 7.4955393428898365, -0.09249506636175525},
+        {5.86145544294642, -12.92096931784711, 8.159367898576159, -0.071584973281401, -0.028269050394068383},
+        {0.09646076681806523, 0.01, 0.4798896504144996, 1.379008574103742, -3.290069515436081, 2.324710524099774}});
+    t.b = {0.09646076681806523, 0.01, 0.4798896504144996, 1.379008574103742, -3.290069515436081, 2.324710524099774, 0.0};
+    t.c = {0.0, 0.161, 0.327, 0.9, 0.9800255409045097, 1.0, 1.0};
+    return t;
+}
+ButcherTableau ButcherTableau::butcher6(){
+    ButcherTableau t;
+    t.name = "butcher6";
+    t.stages = 7;
+    t.order = 6;
+    t.a = lowerTriangle(7, {
+        {1.0 / 3.0},
+        {0.0, 2.0 / 3.0},
+        {1.0 / 12.0, 1.0 / 3.0, -1.0 / 12.0},
+        {-1.0 / 16.0, 9.0 / 8.0, -3.0 / 16.0, -3.0 / 8.0},
+        {0.0, 9.0 / 8.0, -3.0 / 8.0, -3.0 / 4.0, 1.0 / 2.0},
+        {9.0 / 44.0, -9.0 / 11.0, 63.0 / 44.0, 18.0 / 11.0, 0.0, -16.0 / 11.0}});
+    t.b = {11.0 / 120.0, 0.0, 27.0 / 40.0, 27.0 / 40.0, -4.0 / 15.0, -4.0 / 15.0, 11.0 / 120.0};
+    t.c = {0.0, 1.0 / 3.0, 2.0 / 3.0, 1.0 / 3.0, 0.5, 0.5, 1.0};
+    return t;
+}
+ButcherTableau ButcherTableau::cooperVerner8(){
+    const double s = std::sqrt(21.0);
+    ButcherTableau t;
+    t.name = "cv8";
+    t.stages = 11;
+    t.order = 8;
+    t.a = lowerTriangle(11, {
+        {0.5},
+        {0.25, 0.25},
+        {1.0 / 7.0, (-7.0 - 3.0 * s) / 98.0, (21.0 + 5.0 * s) / 49.0},
+        {(11.0 + s) / 84.0, 0.0, (18.0 + 4.0 * s) / 63.0, (21.0 - s) / 252.0},
+        {(5.0 + s) / 48.0, 0.0, (9.0 + s) / 36.0, (-231.0 + 14.0 * s) / 360.0, (63.0 - 7.0 * s) / 80.0},
+        {(10.0 - s) / 42.0, 0.0, (-432.0 + 92.0 * s) / 315.0, (633.0 - 145.0 * s) / 90.0, (-504.0 + 115.0 * s) / 70.0, (63.0 - 13.0 * s) / 35.0},
+        {1.0 / 14.0, 0.0, 0.0, 0.0, (14.0 - 3.0 * s) / 126.0, (13.0 - 3.0 * s) / 63.0, 1.0 / 9.0},
+        {1.0 / 32.0, 0.0, 0.0, 0.0, (91.0 - 21.0 * s) / 576.0, 11.0 / 72.0, (-385.0 - 75.0 * s) / 1152.0, (63.0 + 13.0 * s) / 128.0},
+        {1.0 / 14.0, 0.0, 0.0, 0.0, 1.0 / 9.0, (-733.0 - 147.0 * s) / 2205.0, (515.0 + 111.0 * s) / 504.0, (-51.0 - 11.0 * s) / 56.0, (132.0 + 28.0 * s) / 245.0},
+        {0.0, 0.0, 0.0, 0.0, (-42.0 + 7.0 * s) / 18.0, (-18.0 + 28.0 * s) / 45.0, (-273.0 - 53.0 * s) / 72.0, (301.0 + 53.0 * s) / 72.0, (28.0 - 28.0 * s) / 45.0, (49.0 - 7.0 * s) / 18.0}});
+    t.b = {1.0 / 20.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 49.0 / 180.0, 16.0 / 45.0, 49.0 / 180.0, 1.0 / 20.0};
+    t.c = {0.0, 0.5, 0.5, (7.0 + s) / 14.0, (7.0 + s) / 14.0, 0.5, (7.0 - s) / 14.0, (7.0 - s) / 14.0, 0.5, (7.0 + s) / 14.0, 1.0};
+    return t;
+}
+bool ButcherTableau::isFSAL() const{
+    if(b[stages - 1] != 0.0 || c[stages - 1] != 1.0){
+        return false;
+    }
+    for(int j = 0; j < stages - 1; j++){
+        if(a[(stages - 1) * stages + j] != b[j]){
+            return false;
+        }
+    }
+    return true;
+}
+void ExplicitRungeKutta::prepare() {
+	slopes.assign(tableau.stages, std::vector<double>(dimension));
+	tempState.resize(dimension);
+	firstSameAsLast = tableau.isFSAL();
+	hasFirstSlope = false;
+}
+void ExplicitRungeKutta::step(std::vector<double>& state) {
+	const size_t n = static_cast<size_t>(dimension);
+	const int s = tableau.stages;
+	for (int i = 0; i < s; ++i) {
+		if (i == 0) {
+			if (hasFirstSlope) {
+				slopes[0].swap(slopes[s - 1]);
+			}
+			else {
+				evaluate(state, slopes[0]);
+			}
+			continue;
+		}
+		for (size_t m = 0; m < n; ++m) {
+			tempState[m] = state[m];
+		}
+		for (int j = 0; j < i; ++j) {
+			const double a = tableau.a[i * s + j] * stepSize;
+			if (a == 0.0) {
+				continue;
+			}
+			for (size_t m = 0; m < n; ++m) {
+				tempState[m] += a * slopes[j][m];
+			}
+		}
+		evaluate(tempState, slopes[i]);
+	}
+	if (firstSameAsLast) {
+		// 末级的求值点就是新状态, 其斜率即下一步的首级
+		for (size_t m = 0; m < n; ++m) {
+			state[m] = tempState[m];
+		}
+		hasFirstSlope = true;
+		return;
+	}
+	for (int i = 0; i < s; ++i) {
+		const double b = tableau.b[i] * stepSize;
+		if (b == 0.0) {
+			continue;
+		}
+		for (size_t m = 0; m < n; ++m) {
+			state[m] += b * slopes[i][m];
+		}
+	}
+}
+void LowStorageRungeKutta::prepare() {
+	increment.resize(dimension);
+	slope.resize(dimension);
+}
+void LowStorageRungeKutta::step(std::vector<double>& state) {
+	static const double A[5] = {0.0, -567301805773.0 / 1357537059087.0, -2404267990393.0 / 2016746695238.0,
+		-3550918686646.0 / 2091501179385.0, -1275806237668.0 / 842570457699.0};
+	static const double B[5] = {1432997174477.0 / 9575080441755.0, 5161836677717.0 / 13612068292357.0,
+		1720146321549.0 / 2090206949498.0, 3134564353537.0 / 4481467310338.0, 2277821191437.0 / 14882151754819.0};
+	for (int i = 0; i < 5; ++i) {
+		evaluate(state, slope);
+		for (int m = 0; m < dimension; ++m) {
+			increment[m] = A[i] * increment[m] + stepSize * slope[m];
+			state[m] += B[i] * increment[m];
+		}
+	}
+}
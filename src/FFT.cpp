@@ -0,0 +1,45 @@
+#include "FFT.h"
+#include <cmath>
+#include <stdexcept>
+#include <utility>
+#include "NESFDMUtils.h"
+size_t nextPowerOfTwo(size_t n){
+    size_t p = 1;
+    while(p < n){
+        p <<= 1;
+    }
+    return p;
+}
+void fft(std::vector<std::complex<double>>& data, bool inverse){
+    const size_t n = data.size();
+    if(n == 0 || (n & (n - 1)) != 0){
+        throw std::runtime_error("FFT length must be a power of two.");
+    }
+    // 位反转重排
+    for(size_t i = 1, j = 0; i < n; i++){
+        size_t bit = n >> 1;
+        for(; j & bit; bit >>= 1){
+            j ^= bit;
+        }
+        j ^= bit;
+        if(i < j){
+            std::swap(data[i], data[j]);
+        }
+    }
+    const double sign = inverse ? 1.0 : -1.0;
+    for(size_t len = 2; len <= n; len <<= 1){
+        const double angle = sign * 2.0 * PI / static_cast<double>(len);
+        const std::complex<double> wStep(std::cos(angle), std::sin(angle));
+        const size_t half = len >> 1;
+        for(size_t i = 0; i < n; i += len){
+            std::complex<double> w(1.0, 0.0);
+            for(size_t k = 0; k < half; k++){
+                std::complex<double> u = data[i + k];
+                std::complex<double> v = data[i + k + half] * w;
+                data[i + k] = u + v;
+                data[i + k + half] = u - v;
+                w *= wStep;
+            }
+        }
+    }
+}
@@ -0,0 +1,230 @@
+#include "HarmonicBalanceSolver.h"
+#include "NESSolver.h"
+#include "ShootingSolver.h"
+#include "DenseLinearAlgebra.h"
+#include "FFT.h"
+#include <cmath>
+#include <algorithm>
+#include <limits>
+HarmonicBalanceSolver::HarmonicBalanceSolver(NESSolver& solver_):
+solver(solver_),
+harmonicNum(solver_.getHarmonicNumber()),
+dofNum(1 + solver_.getNESNumber())
+{
+    // 立方非线性会产生 3H 阶谐波, 采样点取 8H 以上以减小混叠
+    sampleNum = std::max<size_t>(32, nextPowerOfTwo(8 * harmonicNum));
+    coeffNum = 2 * harmonicNum + 1;
+    spectrum.resize(sampleNum);
+    disp.assign(dofNum, std::vector<double>(sampleNum));
+    vel.assign(dofNum, std::vector<double>(sampleNum));
+    acc.assign(dofNum, std::vector<double>(sampleNum));
+    state.resize(solver.getDimension());
+    deriv.resize(solver.getDimension());
+}
+void HarmonicBalanceSolver::synthesize(const double* coeff, int order, std::vector<double>& samples){
+    std::fill(spectrum.begin(), spectrum.end(), std::complex<double>(0.0, 0.0));
+    spectrum[0] = order == 0 ? coeff[0] : 0.0;
+    for(size_t k = 1; k <= harmonicNum; k++){
+        double a = coeff[2 * k - 1];
+        double b = coeff[2 * k];
+        double kd = static_cast<double>(k);
+        if(order == 1){
+            double tmp = a;
+            a = kd * b;
+            b = -kd * tmp;
+        }
+        else if(order == 2){
+            a *= -kd * kd;
+            b *= -kd * kd;
+        }
+        spectrum[k] = std::complex<double>(0.5 * a, -0.5 * b);
+        spectrum[sampleNum - k] = std::conj(spectrum[k]);
+    }
+    fft(spectrum, true);
+    for(size_t j = 0; j < sampleNum; j++){
+        samples[j] = spectrum[j].real();
+    }
+}
+void HarmonicBalanceSolver::residual(const std::vector<double>& u, std::vector<double>& r){
+    const size_t n = dofNum - 1;
+    const double D = solver.getMainD();
+    const double omega = u[omegaIndex()];
+    const double omegaN = 2 * PI * solver.getMainFN();
+    const double scale = 1.0 / (omegaN * omegaN * D);
+
+    std::vector<double> coeff(u.begin(), u.begin() + coeffNum);
+    coeff[omegaIndex()] = 0.0;
+    for(size_t q = 0; q < dofNum; q++){
+        const double* c = q == 0 ? coeff.data() : u.data() + q * coeffNum;
+        synthesize(c, 0, disp[q]);
+        synthesize(c, 1, vel[q]);
+        synthesize(c, 2, acc[q]);
+    }
+    // 时域: 残差 = 谐波加速度 - 运动方程给出的加速度
+    for(size_t j = 0; j < sampleNum; j++){
+        state[0] = 0.0;
+        for(size_t q = 0; q < dofNum; q++){
+            state[q + 1] = D * disp[q][j];
+            state[q + n + 2] = D * omega * vel[q][j];
+        }
+        solver.computeDerivatives(state, deriv);
+        for(size_t q = 0; q < dofNum; q++){
+            acc[q][j] = (D * omega * omega * acc[q][j] - deriv[q + n + 2]) * scale;
+        }
+    }
+    // 回到频域
+    const double invM = 1.0 / static_cast<double>(sampleNum);
+    for(size_t q = 0; q < dofNum; q++){
+        for(size_t j = 0; j < sampleNum; j++){
+            spectrum[j] = std::complex<double>(acc[q][j], 0.0);
+        }
+        fft(spectrum);
+        double* out = r.data() + q * coeffNum;
+        out[0] = spectrum[0].real() * invM;
+        for(size_t k = 1; k <= harmonicNum; k++){
+            out[2 * k - 1] = 2.0 * spectrum[k].real() * invM;
+            out[2 * k] = -2.0 * spectrum[k].imag() * invM;
+        }
+    }
+}
+bool HarmonicBalanceSolver::newton(std::vector<double>& u, int& iterations){
+    const size_t total = u.size();
+    auto infNorm = [](const std::vector<double>& v){
+        double m = 0.0;
+        for(double x : v){
+            m = std::max(m, std::abs(x));
+        }
+        return m;
+    };
+    std::vector<double> r(total), rTrial(total), rPerturbed(total), jac(total * total), step(total), uTrial(total);
+    std::vector<int> pivots;
+    residual(u, r);
+    double norm = infNorm(r);
+    for(int iter = 0; iter < maxIterations; iter++){
+        iterations++;
+        if(!isFiniteValue(norm)){
+            return false;
+        }
+        if(norm < tolerance){
+            // 收敛到静止解时不作为周期解
+            return std::abs(u[1]) > 1e-6;
+        }
+        // 前向差分 Jacobian
+        for(size_t c = 0; c < total; c++){
+            const double h = 1e-7 * std::max(std::abs(u[c]), 1e-3);
+            const double saved = u[c];
+            u[c] = saved + h;
+            residual(u, rPerturbed);
+            u[c] = saved;
+            for(size_t i = 0; i < total; i++){
+                jac[i * total + c] = (rPerturbed[i] - r[i]) / h;
+            }
+        }
+        if(!luFactor(jac, pivots, total)){
+            return false;
+        }
+        for(size_t i = 0; i < total; i++){
+            step[i] = -r[i];
+        }
+        luSolve(jac, pivots, step, total);
+        // 限制频率与主结构振幅的单步变化, 避免远离初值时跳到静止解; 残差不下降时步长减半
+        double lambda = 1.0;
+        if(std::abs(step[omegaIndex()]) > 0.1 * u[omegaIndex()]){
+            lambda = 0.1 * u[omegaIndex()] / std::abs(step[omegaIndex()]);
+        }
+        if(std::abs(step[1]) > 0.5 * std::abs(u[1])){
+            lambda = std::min(lambda, 0.5 * std::abs(u[1]) / std::abs(step[1]));
+        }
+        double trialNorm = norm;
+        for(int k = 0; k < 10; k++){
+            for(size_t i = 0; i < total; i++){
+                uTrial[i] = u[i] + lambda * step[i];
+            }
+            residual(uTrial, rTrial);
+            trialNorm = infNorm(rTrial);
+            if(trialNorm < norm){
+                break;
+            }
+            lambda *= 0.5;
+        }
+        if(!(trialNorm < norm) || uTrial[omegaIndex()] <= 0.0){
+            return false;
+        }
+        u.swap(uTrial);
+        r.swap(rTrial);
+        norm = trialNorm;
+    }
+    return false;
+}
+HarmonicBalanceResult HarmonicBalanceSolver::solve(){
+    HarmonicBalanceResult result;
+    const size_t total = dofNum * coeffNum;
+    // 初值: 主结构作一阶谐波振动, NES 振幅取其两倍并滞后 90 度
+    // (相对位移为零时立方刚度的切线刚度为零, Jacobian 奇异), 频率取估计的实际频率.
+    // Newton 的收敛域有限, 依次尝试几个主结构振幅
+    const double seeds[] = {1.0, 1.5, 2.0, 0.5};
+    std::vector<double> u(total);
+    for(double seed : seeds){
+        const double amplitude = seed * solver.getInitialAStar();
+        std::fill(u.begin(), u.end(), 0.0);
+        u[1] = amplitude;
+        for(size_t q = 1; q < dofNum; q++){
+            u[q * coeffNum + 2] = 2.0 * amplitude;
+        }
+        u[omegaIndex()] = 2 * PI * solver.getMainFR();
+        if(newton(u, result.iterations)){
+            result.converged = true;
+            break;
+        }
+    }
+    if(!result.converged){
+        return result;
+    }
+    result.omega = u[omegaIndex()];
+    result.periodTao = 2 * PI / result.omega * solver.getMainFN();
+    result.coefficients.resize(dofNum);
+    for(size_t q = 0; q < dofNum; q++){
+        result.coefficients[q].assign(u.begin() + q * coeffNum, u.begin() + (q + 1) * coeffNum);
+    }
+    std::vector<double>& mainCoeff = result.coefficients[0];
+    mainCoeff[omegaIndex()] = 0.0;
+
+    // Parseval 给出精确 RMS; 最大值在加密网格上取
+    double sumSq = mainCoeff[0] * mainCoeff[0];
+    for(size_t k = 1; k <= harmonicNum; k++){
+        sumSq += 0.5 * (mainCoeff[2 * k - 1] * mainCoeff[2 * k - 1] + mainCoeff[2 * k] * mainCoeff[2 * k]);
+    }
+    result.yRms = std::sqrt(sumSq);
+    const size_t fineNum = 16 * sampleNum;
+    double maxVal = std::numeric_limits<double>::lowest();
+    for(size_t j = 0; j < fineNum; j++){
+        const double theta = 2 * PI * static_cast<double>(j) / static_cast<double>(fineNum);
+        double x = mainCoeff[0];
+        for(size_t k = 1; k <= harmonicNum; k++){
+            x += mainCoeff[2 * k - 1] * std::cos(k * theta) + mainCoeff[2 * k] * std::sin(k * theta);
+        }
+        maxVal = std::max(maxVal, x);
+    }
+    result.yMax = maxVal;
+
+    // theta = 0 处的状态, 用单值矩阵检查稳定性
+    const size_t n = dofNum - 1;
+    const double D = solver.getMainD();
+    std::vector<double> x0(solver.getDimension(), 0.0);
+    for(size_t q = 0; q < dofNum; q++){
+        const std::vector<double>& c = result.coefficients[q];
+        double x = c[0], v = 0.0;
+        for(size_t k = 1; k <= harmonicNum; k++){
+            x += c[2 * k - 1];
+            v += static_cast<double>(k) * c[2 * k];
+        }
+        x0[q + 1] = D * x;
+        x0[q + n + 2] = D * result.omega * v;
+    }
+    PeriodicOrbit orbit;
+    ShootingSolver shooting(solver);
+    shooting.analyzeOrbit(x0, 2 * PI / result.omega, orbit);
+    result.maxFloquet = orbit.maxFloquet;
+    result.stable = orbit.stable;
+    return result;
+}
@@ -0,0 +1,36 @@
+#include "Integrator.h"
+#include "NESFDMUtils.h"
+#include <cmath>
+bool Integrator::checkDivergence(const std::vector<double>& state) const {
+	for (int i = 0; i < dimension; ++i) {
+		if (!isFiniteValue(state[i])) {
+			return true;
+		}
+	}
+	return std::abs(state[divergenceIndex]) > divergenceBound;
+}
+void Integrator::evaluate(const std::vector<double>& state, std::vector<double>& deriv) {
+	if (derivative) {
+		derivative(state, deriv);
+		return;
+	}
+	for (int i = 0; i < dimension; ++i) {
+		deriv[i] = functions[i](state);
+	}
+}
+void Integrator::integrate(std::vector<double>& state) {
+	diverged = false;
+	completedSteps = 0;
+	prepare();
+	stepFunction(state);
+	for (int n = 0; n < numSteps; ++n) {
+		step(state);
+		completedSteps = n + 1;
+		if (divergenceIndex >= 0 && checkDivergence(state)) {
+			diverged = true;
+			return;
+		}
+		// Call the step function
+		stepFunction(state);
+	}
+}
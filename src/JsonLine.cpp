@@ -0,0 +1,260 @@
+#include "JsonLine.h"
+#include "NESFDMUtils.h"
+#include <stdexcept>
+#include <sstream>
+#include <iomanip>
+#include <cstdlib>
+class JsonParser{
+public:
+    explicit JsonParser(const std::string& text_): text(text_){}
+    JsonValue parseDocument(){
+        JsonValue v = parseValue();
+        skipSpace();
+        if(pos != text.size()){
+            fail("unexpected trailing characters");
+        }
+        return v;
+    }
+private:
+    const std::string& text;
+    size_t pos = 0;
+
+    void fail(const std::string& msg) const{
+        throw std::runtime_error("JSON parse error at " + std::to_string(pos) + ": " + msg);
+    }
+    void skipSpace(){
+        while(pos < text.size() && (text[pos] == ' ' || text[pos] == '\t' || text[pos] == '\r' || text[pos] == '\n')){
+            pos++;
+        }
+    }
+    bool consume(char c){
+        skipSpace();
+        if(pos < text.size() && text[pos] == c){
+            pos++;
+            return true;
+        }
+        return false;
+    }
+    void expect(char c){
+        if(!consume(c)){
+            fail(std::string("expected '") + c + "'");
+        }
+    }
+    void expectWord(const char* word){
+        std::string w(word);
+        if(text.compare(pos, w.size(), w) != 0){
+            fail("invalid literal");
+        }
+        pos += w.size();
+    }
+    JsonValue parseValue(){
+        skipSpace();
+        if(pos >= text.size()){
+            fail("unexpected end");
+        }
+        JsonValue v;
+        char c = text[pos];
+        if(c == '{'){
+            pos++;
+            v.type = JsonValue::Type::Object;
+            if(consume('}')){
+                return v;
+            }
+            do{
+                skipSpace();
+                if(pos >= text.size() || text[pos] != '"'){
+                    fail("expected key");
+                }
+                std::string key = parseString();
+                expect(':');
+                v.objectValue.emplace_back(key, parseValue());
+            }while(consume(','));
+            expect('}');
+        }
+        else if(c == '['){
+            pos++;
+            v.type = JsonValue::Type::Array;
+            if(consume(']')){
+                return v;
+            }
+            do{
+                v.arrayValue.push_back(parseValue());
+            }while(consume(','));
+            expect(']');
+        }
+        else if(c == '"'){
+            v.type = JsonValue::Type::String;
+            v.stringValue = parseString();
+        }
+        else if(c == 't'){
+            expectWord("true");
+            v.type = JsonValue::Type::Bool;
+            v.boolValue = true;
+        }
+        else if(c == 'f'){
+            expectWord("false");
+            v.type = JsonValue::Type::Bool;
+        }
+        else if(c == 'n'){
+            expectWord("null");
+        }
+        else{
+            const char* begin = text.c_str() + pos;
+            char* end = nullptr;
+            v.numberValue = std::strtod(begin, &end);
+            if(end == begin){
+                fail("invalid value");
+            }
+            v.type = JsonValue::Type::Number;
+            pos += end - begin;
+        }
+        return v;
+    }
+    std::string parseString(){
+        pos++; // '"'
+        std::string s;
+        while(pos < text.size() && text[pos] != '"'){
+            char c = text[pos++];
+            if(c != '\\'){
+                s += c;
+                continue;
+            }
+            if(pos >= text.size()){
+                fail("unterminated escape");
+            }
+            char e = text[pos++];
+            switch(e){
+                case '"': s += '"'; break;
+                case '\\': s += '\\'; break;
+                case '/': s += '/'; break;
+                case 'b': s += '\b'; break;
+                case 'f': s += '\f'; break;
+                case 'n': s += '\n'; break;
+                case 'r': s += '\r'; break;
+                case 't': s += '\t'; break;
+                case 'u':{
+                    if(pos + 4 > text.size()){
+                        fail("invalid unicode escape");
+                    }
+                    unsigned int code = std::stoul(text.substr(pos, 4), nullptr, 16);
+                    pos += 4;
+                    // 只处理基本多文种平面, 按 UTF-8 编码
+                    if(code < 0x80){
+                        s += static_cast<char>(code);
+                    }
+                    else if(code < 0x800){
+                        s += static_cast<char>(0xC0 | (code >> 6));
+                        s += static_cast<char>(0x80 | (code & 0x3F));
+                    }
+                    else{
+                        s += static_cast<char>(0xE0 | (code >> 12));
+                        s += static_cast<char>(0x80 | ((code >> 6) & 0x3F));
+                        s += static_cast<char>(0x80 | (code & 0x3F));
+                    }
+                    break;
+                }
+                default: fail("invalid escape");
+            }
+        }
+        if(pos >= text.size()){
+            fail("unterminated string");
+        }
+        pos++; // '"'
+        return s;
+    }
+};
+JsonValue JsonValue::parse(const std::string& text){
+    return JsonParser(text).parseDocument();
+}
+const JsonValue* JsonValue::find(const std::string& key) const{
+    for(const auto& kv : objectValue){
+        if(kv.first == key){
+            return &kv.second;
+        }
+    }
+    return nullptr;
+}
+double JsonValue::asNumber(const std::string& what) const{
+    if(type != Type::Number){
+        throw std::runtime_error("\"" + what + "\" must be a number.");
+    }
+    return numberValue;
+}
+bool JsonValue::asBool(const std::string& what) const{
+    if(type != Type::Bool){
+        throw std::runtime_error("\"" + what + "\" must be true or false.");
+    }
+    return boolValue;
+}
+const std::string& JsonValue::asString(const std::string& what) const{
+    if(type != Type::String){
+        throw std::runtime_error("\"" + what + "\" must be a string.");
+    }
+    return stringValue;
+}
+std::vector<double> JsonValue::asNumberArray(const std::string& what) const{
+    if(type == Type::Number){
+        return {numberValue};
+    }
+    if(type != Type::Array){
+        throw std::runtime_error("\"" + what + "\" must be an array of numbers.");
+    }
+    std::vector<double> values;
+    for(const auto& v : arrayValue){
+        values.push_back(v.asNumber(what));
+    }
+    return values;
+}
+std::string JsonValue::dump() const{
+    switch(type){
+        case Type::Null: return "null";
+        case Type::Bool: return boolValue ? "true" : "false";
+        case Type::Number: return jsonNumber(numberValue);
+        case Type::String: return "\"" + jsonEscape(stringValue) + "\"";
+        case Type::Array:{
+            std::string s = "[";
+            for(size_t i = 0; i < arrayValue.size(); i++){
+                s += (i ? "," : "") + arrayValue[i].dump();
+            }
+            return s + "]";
+        }
+        case Type::Object:{
+            std::string s = "{";
+            for(size_t i = 0; i < objectValue.size(); i++){
+                s += (i ? "," : "") + std::string("\"") + jsonEscape(objectValue[i].first) + "\":" + objectValue[i].second.dump();
+            }
+            return s + "}";
+        }
+    }
+    return "null";
+}
+std::string jsonEscape(const std::string& s){
+    std::string out;
+    for(const char c : s){
+        switch(c){
+            case '"': out += "\\\""; break;
+            case '\\': out += "\\\\"; break;
+            case '\n': out += "\\n"; break;
+            case '\r': out += "\\r"; break;
+            case '\t': out += "\\t"; break;
+            default:
+                if(static_cast<unsigned char>(c) < 0x20){
+                    std::ostringstream oss;
+                    oss << "\\u" << std::hex << std::setw(4) << std::setfill('0') << static_cast<int>(c);
+                    out += oss.str();
+                }
+                else{
+                    out += c;
+                }
+        }
+    }
+    return out;
+}
+std::string jsonNumber(double value){
+    if(!isFiniteValue(value)){
+        return "null";
+    }
+    std::ostringstream oss;
+    oss << std::setprecision(10) << value;
+    return oss.str();
+}
@@ -173,3 +173,28 @@ void ModelParameters::getAeroCoeffs(double A_star, double& h1_out, double& h4_ou
 	h1_out = p1.H1_star + delta_A * p1.slope_H1;
 	h4_out = p1.H4_star + delta_A * p1.slope_H4;
 }
+
+void ModelParameters::getAeroCoeffsAndSlopes(double A_star, double& h1_out, double& h4_out, double& dh1_out, double& dh4_out) const {
+	if (A_star <= parameters.front().A_star) {
+		h1_out = parameters.front().H1_star;
+		h4_out = parameters.front().H4_star;
+		dh1_out = 0.0;
+		dh4_out = 0.0;
+		return;
+	}
+	if (A_star >= parameters.back().A_star) {
+		h1_out = parameters.back().H1_star;
+		h4_out = parameters.back().H4_star;
+		dh1_out = 0.0;
+		dh4_out = 0.0;
+		return;
+	}
+	auto it = std::lower_bound(parameters.begin(), parameters.end(), A_star,
+		[](const SingleParameter& p, double val) { return p.A_star < val; });
+	const auto& p1 = *(it - 1);
+	double delta_A = A_star - p1.A_star;
+	h1_out = p1.H1_star + delta_A * p1.slope_H1;
+	h4_out = p1.H4_star + delta_A * p1.slope_H4;
+	dh1_out = p1.slope_H1;
+	dh4_out = p1.slope_H4;
+}
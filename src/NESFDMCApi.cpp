@@ -0,0 +1,169 @@
+#include "NESFDMCApi.h"
+#include "NESJob.h"
+#include <string>
+#include <thread>
+#include <atomic>
+#include <vector>
+#include <algorithm>
+#include <exception>
+#include <cmath>
+
+static thread_local std::string lastError;
+
+static NESJob makeJob(const NESFDMSettings* settings, const NESFDMDesign* design){
+    if(settings == nullptr || design == nullptr){
+        throw std::runtime_error("Null settings or design.");
+    }
+    if(design->nes_number < 0 || design->nes_number > NESFDM_MAX_NES){
+        throw std::runtime_error("NES number must be in 0 ~ " + std::to_string(NESFDM_MAX_NES) + ".");
+    }
+    NESJob job;
+    job.nesNum = design->nes_number;
+    job.mr.assign(design->mr, design->mr + design->nes_number);
+    job.kr.assign(design->kr, design->kr + design->nes_number);
+    job.cr.assign(design->cr, design->cr + design->nes_number);
+    if(settings->config == NESFDM_CONFIG_SINGLE){
+        job.config = "single";
+    }
+    else if(settings->config == NESFDM_CONFIG_1M3U){
+        job.config = "1m3u";
+    }
+    else if(settings->config == NESFDM_CONFIG_3M3U){
+        job.config = "3m3u";
+    }
+    else{
+        throw std::runtime_error("Unsupported config.");
+    }
+    job.UStar = settings->u_star;
+    job.fNatural = settings->f_natural;
+    job.initialAStar = settings->initial_a_star;
+    job.totalTao = settings->total_tao;
+    job.resultCalcStartTao = settings->result_calc_start_tao;
+    job.taoStepSize = settings->tao_step_size;
+    job.fDesign = settings->f_design;
+    job.ksiDesign = settings->ksi_design;
+    job.ksi = settings->ksi;
+    job.divergenceAStar = settings->divergence_a_star;
+    return job;
+}
+static int evaluateOne(const NESFDMSettings* settings, const NESFDMDesign* design, double* y_rms, double* y_max, int* diverged){
+    try{
+        auto results = runJob(makeJob(settings, design));
+        for(size_t i = 0; i < results.size(); i++){
+            // 发散时 DisplacementResults 中为占位的 0, 对外写 HUGE_VAL, 调用方不检查 diverged 也不会当作最优解
+            y_rms[i] = results[i].diverged ? HUGE_VAL : results[i].yRms;
+            y_max[i] = results[i].diverged ? HUGE_VAL : results[i].yMax;
+            if(diverged != nullptr){
+                diverged[i] = results[i].diverged ? 1 : 0;
+            }
+        }
+        return NESFDM_OK;
+    }
+    catch(const std::exception& e){
+        lastError = e.what();
+    }
+    catch(...){
+        lastError = "Unknown error.";
+    }
+    return NESFDM_ERROR;
+}
+
+const char* nesfdm_version(void){
+    return "1.0.2";
+}
+const char* nesfdm_last_error(void){
+    return lastError.c_str();
+}
+void nesfdm_default_settings(NESFDMSettings* settings){
+    if(settings == nullptr){
+        return;
+    }
+    NESJob job;
+    settings->config = NESFDM_CONFIG_SINGLE;
+    settings->u_star = job.UStar;
+    settings->f_natural = job.fNatural;
+    settings->initial_a_star = job.initialAStar;
+    settings->total_tao = job.totalTao;
+    settings->result_calc_start_tao = job.resultCalcStartTao;
+    settings->tao_step_size = job.taoStepSize;
+    settings->f_design = job.fDesign;
+    settings->ksi_design = job.ksiDesign;
+    settings->ksi = job.ksi;
+    settings->divergence_a_star = job.divergenceAStar;
+}
+int nesfdm_results_per_design(const NESFDMSettings* settings){
+    if(settings == nullptr){
+        return 0;
+    }
+    switch(settings->config){
+        case NESFDM_CONFIG_SINGLE: return 1;
+        case NESFDM_CONFIG_1M3U: return 3;
+        case NESFDM_CONFIG_3M3U: return 9;
+        default: return 0;
+    }
+}
+int nesfdm_evaluate(const NESFDMSettings* settings, const NESFDMDesign* design, double* y_rms, double* y_max, int* diverged){
+    return evaluateOne(settings, design, y_rms, y_max, diverged);
+}
+int nesfdm_evaluate_batch(
+    const NESFDMSettings* settings,
+    const NESFDMDesign* designs,
+    size_t count,
+    int thread_num,
+    double* y_rms,
+    double* y_max,
+    int* diverged,
+    int* status
+){
+    const int stride = nesfdm_results_per_design(settings);
+    if(stride == 0){
+        lastError = "Unsupported config.";
+        return NESFDM_ERROR;
+    }
+    unsigned int workerNum = thread_num > 0 ? static_cast<unsigned int>(thread_num) : std::max(std::thread::hardware_concurrency(), 1u);
+    workerNum = static_cast<unsigned int>(std::min<size_t>(workerNum, std::max<size_t>(count, 1)));
+
+    std::atomic<size_t> next{0};
+    std::atomic<bool> failed{false};
+    std::string firstError;
+    std::atomic<bool> errorRecorded{false};
+    auto worker = [&](){
+        while(true){
+            size_t i = next++;
+            if(i >= count){
+                break;
+            }
+            int rc = evaluateOne(
+                settings, designs + i,
+                y_rms + i * stride, y_max + i * stride,
+                diverged == nullptr ? nullptr : diverged + i * stride
+            );
+            if(status != nullptr){
+                status[i] = rc;
+            }
+            if(rc != NESFDM_OK){
+                failed = true;
+                if(!errorRecorded.exchange(true)){
+                    firstError = lastError;
+                }
+            }
+        }
+    };
+    if(workerNum <= 1){
+        worker();
+    }
+    else{
+        std::vector<std::thread> threads;
+        for(unsigned int i = 0; i < workerNum; i++){
+            threads.emplace_back(worker);
+        }
+        for(auto& t : threads){
+            t.join();
+        }
+    }
+    if(failed){
+        lastError = firstError;
+        return NESFDM_ERROR;
+    }
+    return NESFDM_OK;
+}
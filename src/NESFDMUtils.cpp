@@ -10,47 +10,41 @@
 #include <algorithm>
 #include <functional>
 #include <math.h>
+#include <cstring>
+#include <cstdint>
 #include "NESFDMUtils.h"
 bool isEQ(double a, double b) {
 	return std::abs(a - b) < 1e-10;
 }
-
-
-double getRms(const std::vector<std::vector<double>>& data,
-	size_t index, double startTime)
-{
-	if (data.empty() || index >= data[0].size()) return 0.0;
-
-	double dt = data[1][0] - data[0][0];
-	size_t startIndex = static_cast<size_t>(startTime / dt);
-
-	if (startIndex >= data.size()) return 0.0;
-
-	double sum = 0.0;
-	size_t count = data.size();
-
-	for (size_t i = startIndex; i < count; i++) {
-		sum += data[i][index] * data[i][index];
+bool isFiniteValue(double x) {
+	std::uint64_t bits;
+	std::memcpy(&bits, &x, sizeof(bits));
+	return (bits & 0x7FF0000000000000ULL) != 0x7FF0000000000000ULL;
+}
+bool anyDiverged(const std::vector<DisplacementResults>& allResults) {
+	for (const auto& r : allResults) {
+		if (r.diverged) {
+			return true;
+		}
 	}
-
-	return std::sqrt(sum / (count - startIndex));
+	return false;
 }
-double getMax(const std::vector<std::vector<double>>& data, size_t index, double startTime) {
-	if (data.empty() || index >= data[0].size()) return 0.0;
-	double dt = data[1][0] - data[0][0];
-	size_t startIndex = static_cast<size_t>(startTime / dt);
-	if (startIndex >= data.size()) return 0.0;
-	double maxVal = std::numeric_limits<double>::lowest();
-	for (size_t i = startIndex; i < data.size(); i++) {
-		if (data[i][index] > maxVal) {
-			maxVal = data[i][index];
+bool exceedsStroke(const std::vector<DisplacementResults>& allResults, double limit) {
+	for (const auto& r : allResults) {
+		for (const auto& s : r.strokes) {
+			if (s.max > limit) {
+				return true;
+			}
 		}
 	}
-	return maxVal;
+	return false;
 }
 
 
 void get_avg_max(const std::vector<DisplacementResults>& allResults, double& jYRms, double& jYMax) {
+	if (anyDiverged(allResults)) {
+		throw std::runtime_error("Objective of diverged results is undefined.");
+	}
 	jYRms = 0.0;
 	jYMax = 0.0;
 	std::function<double(double, double, double)> max = [](double a, double b, double c) {
@@ -88,4 +82,58 @@ void get_avg_max(const std::vector<DisplacementResults>& allResults, double& jYR
 		allResults[8].yMax
 	);
 	jYMax = (maxY1 + maxY2 + maxY3) / 3.0;
-}
\ No newline at end of file
+}
+ObjectiveType parseObjective(const std::string& name) {
+	if (name == "avg" || name == "average") {
+		return ObjectiveType::Avg;
+	}
+	if (name == "max") {
+		return ObjectiveType::Max;
+	}
+	if (name == "avg_max" || name == "max_avg") {
+		return ObjectiveType::AvgMax;
+	}
+	if (name == "tet") {
+		return ObjectiveType::Tet;
+	}
+	throw std::runtime_error("Unsupported objective function \"" + name + "\".");
+}
+double getObjective(const std::vector<DisplacementResults>& allResults, ObjectiveType type) {
+	if (allResults.empty()) {
+		throw std::runtime_error("No results for objective function.");
+	}
+	if (anyDiverged(allResults)) {
+		throw std::runtime_error("Objective of diverged results is undefined.");
+	}
+	if (type == ObjectiveType::Avg) {
+		double sum = 0.0;
+		for (const auto& r : allResults) {
+			sum += r.yRms;
+		}
+		return sum / allResults.size();
+	}
+	if (type == ObjectiveType::Max) {
+		double maxVal = std::numeric_limits<double>::lowest();
+		for (const auto& r : allResults) {
+			maxVal = std::max(maxVal, r.yRms);
+		}
+		return maxVal;
+	}
+	if (type == ObjectiveType::Tet) {
+		double sum = 0.0;
+		size_t count = 0;
+		for (const auto& r : allResults) {
+			if (r.energy.valid) {
+				sum += r.energy.tetRatio();
+				count++;
+			}
+		}
+		return count > 0 ? 1.0 - sum / count : 1.0;
+	}
+	if (allResults.size() != 9) {
+		throw std::runtime_error("Objective avg_max requires 3m3u results.");
+	}
+	double jYRms, jYMax;
+	get_avg_max(allResults, jYRms, jYMax);
+	return jYRms;
+}
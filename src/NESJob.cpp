@@ -0,0 +1,76 @@
+#include "NESJob.h"
+#include "NESSolver.h"
+void checkJob(const NESJob& job){
+    if(job.nesNum < 0){
+        throw std::runtime_error("NES number must not be negative.");
+    }
+    size_t n = static_cast<size_t>(job.nesNum);
+    if(job.mr.size() != n || job.kr.size() != n || job.cr.size() != n){
+        throw std::runtime_error("mr, kr and cr must have " + std::to_string(n) + " values.");
+    }
+    for(double mr : job.mr){
+        if(!(mr > 0.0)){
+            throw std::runtime_error("Mass ratio must be positive.");
+        }
+    }
+    // 时间参数不合理时积分步数无意义, 不能给出结果
+    if(!(job.taoStepSize > 0.0) || !(job.totalTao > 0.0)){
+        throw std::runtime_error("dtao and ctao must be positive.");
+    }
+    if(!(job.resultCalcStartTao >= 0.0) || !(job.resultCalcStartTao < job.totalTao)){
+        throw std::runtime_error("rctao must be in [0, ctao).");
+    }
+    for(double tao : job.extraCalcStartTaos){
+        if(!(tao >= 0.0) || !(tao < job.totalTao)){
+            throw std::runtime_error("extra_rctao must be in [0, ctao).");
+        }
+    }
+    if(job.config != "single" && job.config != "1m3u" && job.config != "3m3u"){
+        throw std::runtime_error("Unsupported config.");
+    }
+    parseObjective(job.objective);
+    parseSolverMethod(job.method);
+    parseIntegratorType(job.integrator);
+    if(job.shootingTransientTao < 0){
+        throw std::runtime_error("Shooting transient tao must not be negative.");
+    }
+    if(job.harmonicNumber < 1){
+        throw std::runtime_error("Harmonic number must be positive.");
+    }
+}
+std::vector<DisplacementResults> runJob(const NESJob& job){
+    checkJob(job);
+    NESSolver solver(job.nesNum);
+    solver.setMainDampingRatio(job.ksi);
+    solver.setDesignDampingRatio(job.ksiDesign);
+    solver.setInitialAStar(job.initialAStar);
+    solver.setTotalTao(job.totalTao);
+    solver.setResultCalcStartTao(job.resultCalcStartTao);
+    solver.setExtraCalcStartTaos(job.extraCalcStartTaos);
+    solver.setTaoStepSize(job.taoStepSize);
+    solver.setDivergenceAStar(job.divergenceAStar);
+    solver.setMethod(parseSolverMethod(job.method));
+    solver.setShootingTransientTao(job.shootingTransientTao);
+    solver.setHarmonicNumber(static_cast<unsigned int>(job.harmonicNumber));
+    solver.setSlowFlowStart(job.slowFlowStart);
+    solver.setLinearPrescreen(job.linearPrescreen);
+    solver.setSpectralAnalysis(job.spectrum);
+    solver.setEnergyMetrics(job.energy || parseObjective(job.objective) == ObjectiveType::Tet);
+    solver.setStrokeStatistics(job.stroke);
+    solver.setIntegrator(parseIntegratorType(job.integrator));
+    solver.setFD(job.fDesign);
+    for(int i = 1; i <= job.nesNum; i++){
+        solver.setNESMr(i, job.mr[i-1]);
+        solver.setNESKr(i, job.kr[i-1]);
+        solver.setNESCr(i, job.cr[i-1]);
+    }
+    if(job.config == "single"){
+        solver.setMainFN(job.fNatural);
+        solver.setUStar(job.UStar);
+        return {solver.run()};
+    }
+    if(job.config == "1m3u"){
+        return solver.runConfig1m3u();
+    }
+    return solver.runConfig3m3u();
+}
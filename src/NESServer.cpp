@@ -0,0 +1,271 @@
+#include "NESServer.h"
+#include "NESSolver.h"
+#include <memory>
+#include <thread>
+#include <functional>
+#ifndef _WIN32
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <cstring>
+#include <cerrno>
+#ifndef MSG_NOSIGNAL
+#define MSG_NOSIGNAL 0
+#endif
+#endif
+NESServer::NESServer(const NESJob& defaults_, unsigned int threadNum):
+defaults(defaults_),
+pool(threadNum)
+{
+
+}
+NESJob NESServer::parseJob(const JsonValue& request) const{
+    if(request.type != JsonValue::Type::Object){
+        throw std::runtime_error("Job must be a JSON object.");
+    }
+    NESJob job = defaults;
+    auto number = [&request](const char* key, double& target){
+        if(const JsonValue* v = request.find(key)){
+            target = v->asNumber(key);
+        }
+    };
+    if(const JsonValue* v = request.find("n")){
+        job.nesNum = static_cast<int>(v->asNumber("n"));
+    }
+    if(const JsonValue* v = request.find("mr")){ job.mr = v->asNumberArray("mr"); }
+    if(const JsonValue* v = request.find("kr")){ job.kr = v->asNumberArray("kr"); }
+    if(const JsonValue* v = request.find("cr")){ job.cr = v->asNumberArray("cr"); }
+    if(const JsonValue* v = request.find("config")){ job.config = v->asString("config"); }
+    if(const JsonValue* v = request.find("objective")){ job.objective = v->asString("objective"); }
+    if(const JsonValue* v = request.find("method")){ job.method = v->asString("method"); }
+    if(const JsonValue* v = request.find("integrator")){ job.integrator = v->asString("integrator"); }
+    if(const JsonValue* v = request.find("prescreen")){ job.linearPrescreen = v->asBool("prescreen"); }
+    if(const JsonValue* v = request.find("slow_start")){ job.slowFlowStart = v->asBool("slow_start"); }
+    if(const JsonValue* v = request.find("spectrum")){ job.spectrum = v->asBool("spectrum"); }
+    if(const JsonValue* v = request.find("energy")){ job.energy = v->asBool("energy"); }
+    if(const JsonValue* v = request.find("stroke")){ job.stroke = v->asBool("stroke"); }
+    if(const JsonValue* v = request.find("extra_rctao")){ job.extraCalcStartTaos = v->asNumberArray("extra_rctao"); }
+    number("ustar", job.UStar);
+    number("fn", job.fNatural);
+    number("a", job.initialAStar);
+    number("ctao", job.totalTao);
+    number("rctao", job.resultCalcStartTao);
+    number("shoot_ttao", job.shootingTransientTao);
+    number("dtao", job.taoStepSize);
+    number("fd", job.fDesign);
+    number("ksi_design", job.ksiDesign);
+    number("ksi", job.ksi);
+    number("diverge_a_star", job.divergenceAStar);
+    number("harmonics", job.harmonicNumber);
+    checkJob(job);
+    return job;
+}
+namespace {
+// 可选统计量 (附加统计区间, 频谱, 能量, 行程) 的结果字段, 每个工况一项
+std::string optionalResults(const NESJob& job, const std::vector<DisplacementResults>& results){
+    auto perCase = [&results](const std::function<std::string(const DisplacementResults&)>& field){
+        std::string s = "[";
+        for(size_t i = 0; i < results.size(); i++){
+            s += (i ? "," : "") + field(results[i]);
+        }
+        return s + "]";
+    };
+    auto numbers = [](const std::vector<double>& values){
+        std::string s = "[";
+        for(size_t i = 0; i < values.size(); i++){
+            s += (i ? "," : "") + jsonNumber(values[i]);
+        }
+        return s + "]";
+    };
+    std::string out;
+    if(!job.extraCalcStartTaos.empty()){
+        out += ",\"windowRms\":" + perCase([&](const DisplacementResults& r){ return r.diverged ? std::string("null") : numbers(r.windowRms); });
+        out += ",\"windowMax\":" + perCase([&](const DisplacementResults& r){ return r.diverged ? std::string("null") : numbers(r.windowMax); });
+    }
+    if(job.spectrum){
+        out += ",\"spectra\":" + perCase([](const DisplacementResults& r){
+            std::string s = "[";
+            for(size_t k = 0; k < r.spectra.size(); k++){
+                const SpectralFeatures& f = r.spectra[k];
+                s += std::string(k ? "," : "") + "{\"fdom\":" + jsonNumber(f.dominantFrequency)
+                    + ",\"sub\":" + jsonNumber(f.subharmonicFraction)
+                    + ",\"super\":" + jsonNumber(f.superharmonicFraction)
+                    + ",\"mod\":" + jsonNumber(f.modulationIndex) + "}";
+            }
+            return s + "]";
+        });
+    }
+    if(job.energy || parseObjective(job.objective) == ObjectiveType::Tet){
+        out += ",\"energy\":" + perCase([&](const DisplacementResults& r){
+            if(!r.energy.valid){
+                return std::string("null");
+            }
+            return "{\"aero\":" + jsonNumber(r.energy.aeroInput)
+                + ",\"struct\":" + jsonNumber(r.energy.structuralFraction)
+                + ",\"nes\":" + numbers(r.energy.nesFractions) + "}";
+        });
+    }
+    // 非时域方法: 实际采用的方法, 是否改用了时域积分, 以及周期解的周期和 Floquet 乘子最大模 (没有时为 null)
+    if(parseSolverMethod(job.method) != SolverMethod::TimeDomain){
+        out += ",\"method\":" + perCase([](const DisplacementResults& r){ return "\"" + r.method + "\""; });
+        out += ",\"fallback\":" + perCase([](const DisplacementResults& r){ return std::string(r.fallback ? "true" : "false"); });
+        out += ",\"periodTao\":" + perCase([](const DisplacementResults& r){ return r.periodTao > 0.0 ? jsonNumber(r.periodTao) : std::string("null"); });
+        out += ",\"maxFloquet\":" + perCase([](const DisplacementResults& r){ return r.periodTao > 0.0 ? jsonNumber(r.maxFloquet) : std::string("null"); });
+    }
+    if(job.stroke){
+        out += ",\"strokes\":" + perCase([](const DisplacementResults& r){
+            std::string s = "[";
+            for(size_t k = 0; k < r.strokes.size(); k++){
+                const StrokeStatistics& st = r.strokes[k];
+                s += std::string(k ? "," : "") + "{\"rms\":" + jsonNumber(st.rms)
+                    + ",\"max\":" + jsonNumber(st.max) + ",\"force\":" + jsonNumber(st.peakForce) + "}";
+            }
+            return s + "]";
+        });
+    }
+    return out;
+}
+}
+std::string NESServer::handle(const std::string& line) const{
+    std::string id = "null";
+    try{
+        JsonValue request = JsonValue::parse(line);
+        if(request.type == JsonValue::Type::Object){
+            if(const JsonValue* v = request.find("id")){
+                id = v->dump();
+            }
+        }
+        NESJob job = parseJob(request);
+        auto results = runJob(job);
+
+        std::string yRms, yMax, diverged, prescreened;
+        for(size_t i = 0; i < results.size(); i++){
+            std::string sep = i ? "," : "";
+            // 发散工况的 yRms/yMax 没有意义, 写作 null
+            yRms += sep + (results[i].diverged ? std::string("null") : jsonNumber(results[i].yRms));
+            yMax += sep + (results[i].diverged ? std::string("null") : jsonNumber(results[i].yMax));
+            diverged += sep + (results[i].diverged ? "true" : "false");
+            prescreened += sep + (results[i].prescreened ? "true" : "false");
+        }
+        std::string out = "{\"id\":" + id + ",\"status\":\"ok\""
+            + ",\"yRms\":[" + yRms + "],\"yMax\":[" + yMax + "],\"diverged\":[" + diverged + "]";
+        if(job.linearPrescreen){
+            out += ",\"prescreened\":[" + prescreened + "]";
+        }
+        out += optionalResults(job, results);
+        if(job.config == "3m3u"){
+            out += ",\"objective\":" + (anyDiverged(results) ? std::string("null") : jsonNumber(getObjective(results, parseObjective(job.objective))));
+        }
+        return out + "}";
+    }
+    catch(const std::exception& e){
+        return "{\"id\":" + id + ",\"status\":\"error\",\"message\":\"" + jsonEscape(e.what()) + "\"}";
+    }
+}
+void NESServer::serveStream(std::istream& is, std::ostream& os){
+    std::mutex outMtx;
+    std::string line;
+    while(std::getline(is, line)){
+        if(line.find_first_not_of(" \t\r") == std::string::npos){
+            continue;
+        }
+        pool.submit([this, line, &os, &outMtx](){
+            std::string result = handle(line);
+            std::lock_guard<std::mutex> lock(outMtx);
+            os << result << "\n" << std::flush;
+        });
+    }
+    pool.wait();
+}
+#ifndef _WIN32
+// 连接在读线程和所有未完成任务都释放后关闭
+struct ServerConnection{
+    int fd;
+    std::mutex writeMtx;
+    explicit ServerConnection(int fd_): fd(fd_){}
+    ~ServerConnection(){ close(fd); }
+    void writeLine(const std::string& s){
+        std::lock_guard<std::mutex> lock(writeMtx);
+        std::string data = s + "\n";
+        size_t sent = 0;
+        while(sent < data.size()){
+            ssize_t n = send(fd, data.data() + sent, data.size() - sent, MSG_NOSIGNAL);
+            if(n <= 0){
+                if(n < 0 && errno == EINTR){
+                    continue;
+                }
+                return; // 客户端已断开
+            }
+            sent += static_cast<size_t>(n);
+        }
+    }
+};
+void NESServer::serveUnixSocket(const std::string& path){
+    int listenFd = socket(AF_UNIX, SOCK_STREAM, 0);
+    if(listenFd < 0){
+        throw std::runtime_error("Cannot create socket.");
+    }
+    sockaddr_un addr{};
+    addr.sun_family = AF_UNIX;
+    if(path.size() >= sizeof(addr.sun_path)){
+        close(listenFd);
+        throw std::runtime_error("Socket path is too long.");
+    }
+    std::strncpy(addr.sun_path, path.c_str(), sizeof(addr.sun_path) - 1);
+    // 只清理上次遗留的 socket 文件, 不删除同名的其他文件
+    struct stat st;
+    if(lstat(path.c_str(), &st) == 0){
+        if(!S_ISSOCK(st.st_mode)){
+            close(listenFd);
+            throw std::runtime_error("\"" + path + "\" exists and is not a socket.");
+        }
+        unlink(path.c_str());
+    }
+    if(bind(listenFd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) != 0 || listen(listenFd, 16) != 0){
+        close(listenFd);
+        throw std::runtime_error("Cannot listen on socket \"" + path + "\": " + std::strerror(errno));
+    }
+    std::cerr << "Listening on " << path << std::endl;
+    while(true){
+        int fd = accept(listenFd, nullptr, nullptr);
+        if(fd < 0){
+            if(errno == EINTR){
+                continue;
+            }
+            close(listenFd);
+            throw std::runtime_error(std::string("accept() failed: ") + std::strerror(errno));
+        }
+        auto conn = std::make_shared<ServerConnection>(fd);
+        std::thread([this, conn](){
+            std::string buffer;
+            char chunk[4096];
+            while(true){
+                ssize_t n = recv(conn->fd, chunk, sizeof(chunk), 0);
+                if(n < 0 && errno == EINTR){
+                    continue;
+                }
+                if(n <= 0){
+                    break;
+                }
+                buffer.append(chunk, static_cast<size_t>(n));
+                size_t newline;
+                while((newline = buffer.find('\n')) != std::string::npos){
+                    std::string line = buffer.substr(0, newline);
+                    buffer.erase(0, newline + 1);
+                    if(line.find_first_not_of(" \t\r") == std::string::npos){
+                        continue;
+                    }
+                    pool.submit([this, conn, line](){
+                        conn->writeLine(handle(line));
+                    });
+                }
+            }
+        }).detach();
+    }
+}
+#else
+void NESServer::serveUnixSocket(const std::string& path){
+    throw std::runtime_error("Unix socket is not supported on this platform, use stdin instead.");
+}
+#endif
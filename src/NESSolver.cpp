@@ -1,7 +1,63 @@
 #include "NESSolver.h"
 
 #include "RungeKutta4.h"
+#include "Rosenbrock.h"
+#include "ETDRK4.h"
+#include "ExplicitRungeKutta.h"
+#include "ResponseStatistics.h"
+#include "CycleTracker.h"
+#include "PoincareSection.h"
+#include "SpectrumAnalyzer.h"
+#include "EnergyBalance.h"
+#include "StateHistory.h"
+#include "ColumnarHistory.h"
+#include "ShootingSolver.h"
+#include "HarmonicBalanceSolver.h"
+#include "SlowFlowSolver.h"
+#include "DenseLinearAlgebra.h"
 #include <math.h>
+SolverMethod parseSolverMethod(const std::string& name){
+    if(name == "time"){
+        return SolverMethod::TimeDomain;
+    }
+    if(name == "shooting"){
+        return SolverMethod::Shooting;
+    }
+    if(name == "hb" || name == "harmonic_balance"){
+        return SolverMethod::HarmonicBalance;
+    }
+    if(name == "slow" || name == "slow_flow"){
+        return SolverMethod::SlowFlow;
+    }
+    throw std::runtime_error("Unsupported solver method \"" + name + "\".");
+}
+IntegratorType parseIntegratorType(const std::string& name){
+    if(name == "rk4"){
+        return IntegratorType::RK4;
+    }
+    if(name == "ros2"){
+        return IntegratorType::Ros2;
+    }
+    if(name == "rodas3"){
+        return IntegratorType::Rodas3;
+    }
+    if(name == "etdrk4"){
+        return IntegratorType::ETDRK4;
+    }
+    if(name == "ck4"){
+        return IntegratorType::LowStorage4;
+    }
+    if(name == "tsit5"){
+        return IntegratorType::Tsit5;
+    }
+    if(name == "butcher6"){
+        return IntegratorType::Butcher6;
+    }
+    if(name == "cv8"){
+        return IntegratorType::CooperVerner8;
+    }
+    throw std::runtime_error("Unsupported integrator \"" + name + "\".");
+}
 
 NESSolver::NESSolver(const unsigned int nesNumber_):
 nesNumber(nesNumber_),
@@ -66,6 +122,26 @@ void NESSolver::setResultCalcStartTao(double resultCalcStartTime_){
     refreshTao();
 }
 
+void NESSolver::setDivergenceAStar(double a_){
+    if(a_ <= 0){
+        throw std::runtime_error("Divergence A* bound must be positive.");
+    }
+    divergenceAStar = a_;
+}
+void NESSolver::setHarmonicNumber(unsigned int h_){
+    if(h_ == 0){
+        throw std::runtime_error("Harmonic number must be positive.");
+    }
+    harmonicNumber = h_;
+}
+
+void NESSolver::setInitialState(const std::vector<double>& state_){
+    if(state_.size() != dimension){
+        throw std::runtime_error("Dimension of initial state does not match the solver.");
+    }
+    initialState = state_;
+}
+
 void NESSolver::setNESMr(size_t i, double mr_){
     if(i == 0 || i > nesNumber){
         throw std::runtime_error("Index out of range in setNESMr, i is a 1-based index.");
@@ -101,11 +177,7 @@ void NESSolver::setNESCr(size_t i, double cr_){
     this->nes[i-1].cr = cr_;
     this->nes[i-1].c = cDesign * cr_;
 }
-DisplacementResults NESSolver::run(){
-    refreshAll();
-    int numSteps = static_cast<int>(totalTime / timeStepSize);
-    
-    RungeKutta4 rk4(dimension, timeStepSize, numSteps, funcs);
+std::vector<double> NESSolver::getStartState() const{
     double D = main.getD();
     std::vector<double> state;
     state.push_back(0.0);
@@ -115,52 +187,289 @@ DisplacementResults NESSolver::run(){
     for(int i = 1; i <= nesNumber + 1; i++){
         state.push_back(0.0);
     }
+    return state;
+}
+DisplacementResults NESSolver::run(){
+    if(linearPrescreen){
+        refreshAll();
+        LinearStability linear = checkLinearStability();
+        if(linear.stable){
+            DisplacementResults decay = linearDecayResults(linear);
+            decay.method = "linear";
+            return decay;
+        }
+    }
+    // 周期解法收敛时记录周期和 Floquet 乘子, 不稳定而改用时域积分时也保留
+    double periodTao = 0.0, maxFloquet = 0.0;
+    if(method == SolverMethod::Shooting){
+        refreshAll();
+        ShootingSolver shooting(*this);
+        PeriodicOrbit orbit = shooting.solve();
+        if(orbit.converged){
+            periodTao = orbit.periodTao;
+            maxFloquet = orbit.maxFloquet;
+        }
+        // 未收敛或周期解不稳定时, 时域积分得到的才是实际响应
+        if(orbit.converged && orbit.stable){
+            DisplacementResults results{ orbit.yRms, orbit.yMax };
+            results.method = "shooting";
+            results.periodTao = periodTao;
+            results.maxFloquet = maxFloquet;
+            return withWindows(results);
+        }
+    }
+    else if(method == SolverMethod::HarmonicBalance){
+        refreshAll();
+        HarmonicBalanceSolver hb(*this);
+        HarmonicBalanceResult periodic = hb.solve();
+        if(periodic.converged){
+            periodTao = periodic.periodTao;
+            maxFloquet = periodic.maxFloquet;
+        }
+        // 与打靶法相同: 未收敛或周期解不稳定时改用时域积分
+        if(periodic.converged && periodic.stable){
+            DisplacementResults results{ periodic.yRms, periodic.yMax };
+            results.method = "hb";
+            results.periodTao = periodTao;
+            results.maxFloquet = maxFloquet;
+            return withWindows(results);
+        }
+    }
+    else if(method == SolverMethod::SlowFlow){
+        refreshAll();
+        SlowFlowSolver slowFlow(*this);
+        SlowFlowResult approx = slowFlow.solve();
+        DisplacementResults results{ approx.yRms, approx.yMax };
+        results.diverged = approx.diverged;
+        results.divergedTao = approx.divergedTao;
+        results.method = "slow";
+        return withWindows(results);
+    }
+    DisplacementResults results = runTimeDomain();
+    results.fallback = method == SolverMethod::Shooting || method == SolverMethod::HarmonicBalance;
+    results.periodTao = periodTao;
+    results.maxFloquet = maxFloquet;
+    return results;
+}
+DisplacementResults NESSolver::withWindows(DisplacementResults results) const{
+    results.windowRms.assign(extraCalcStartTaos.size(), results.yRms);
+    results.windowMax.assign(extraCalcStartTaos.size(), results.yMax);
+    return results;
+}
+std::unique_ptr<Integrator> NESSolver::makeIntegrator(int numSteps) const{
+    if(integratorType == IntegratorType::Ros2 || integratorType == IntegratorType::Rodas3){
+        return std::make_unique<Rosenbrock>(dimension, timeStepSize, numSteps,
+            [this](const std::vector<double>& state, std::vector<double>& deriv){ computeDerivatives(state, deriv); },
+            [this](const std::vector<double>& state, std::vector<double>& jac){ computeJacobian(state, jac); },
+            integratorType == IntegratorType::Ros2 ? RosenbrockTableau::ros2() : RosenbrockTableau::rodas3());
+    }
+    if(integratorType == IntegratorType::ETDRK4){
+        std::vector<double> linear;
+        computeStructuralMatrix(linear);
+        return std::make_unique<ETDRK4>(dimension, timeStepSize, numSteps,
+            [this](const std::vector<double>& state, std::vector<double>& deriv){ computeDerivatives(state, deriv); },
+            linear);
+    }
+    if(integratorType == IntegratorType::LowStorage4){
+        return std::make_unique<LowStorageRungeKutta>(dimension, timeStepSize, numSteps,
+            [this](const std::vector<double>& state, std::vector<double>& deriv){ computeDerivatives(state, deriv); });
+    }
+    if(integratorType == IntegratorType::Tsit5 || integratorType == IntegratorType::Butcher6 ||
+        integratorType == IntegratorType::CooperVerner8){
+        return std::make_unique<ExplicitRungeKutta>(dimension, timeStepSize, numSteps,
+            [this](const std::vector<double>& state, std::vector<double>& deriv){ computeDerivatives(state, deriv); },
+            integratorType == IntegratorType::Tsit5 ? ButcherTableau::tsitouras5() :
+            integratorType == IntegratorType::Butcher6 ? ButcherTableau::butcher6() : ButcherTableau::cooperVerner8());
+    }
+    return std::make_unique<RungeKutta4>(dimension, timeStepSize, numSteps, funcs);
+}
+DisplacementResults NESSolver::runTimeDomain(){
+    refreshAll();
+    int numSteps = static_cast<int>(totalTime / timeStepSize);
     
+    std::unique_ptr<Integrator> integrator = makeIntegrator(numSteps);
+    double D = main.getD();
+    std::vector<double> state;
+    if(!initialState.empty()){
+        state = initialState;
+        state[0] = 0.0;
+    }
+    else if(slowFlowStart){
+        SlowFlowSolver slowFlow(*this);
+        SlowFlowResult approx = slowFlow.solve();
+        state = approx.diverged ? getStartState() : slowFlow.toState(approx);
+    }
+    else{
+        state = getStartState();
+    }
     
-    std::ofstream ofs(outputFile);
-	std::vector<std::vector<double>> results;
-	std::function<void(const std::vector<double>&)> stepFunction;
+    
+    std::ofstream ofs;
+	std::unique_ptr<ColumnarHistoryWriter> columnar;
 	if (!outputFile.empty()) {
-        
-		stepFunction =
-			[&ofs, &results](const std::vector<double>& state) {
+		if (outputChunkSize > 0) {
+			columnar = std::make_unique<ColumnarHistoryWriter>(outputFile, dimension, outputChunkSize, stateHeader(nesNumber));
+		}
+		else {
+			ofs.open(outputFile);
+		}
+	}
+	// 主结构位移的统计量逐步累计, 不保存时程; 第 0 个为主统计区间, 其后为附加区间
+	std::vector<ResponseStatistics> statistics;
+	statistics.emplace_back(1, nesNumber + 2, resultCalcStartTime);
+	for (double tao : extraCalcStartTaos) {
+		statistics.emplace_back(1, nesNumber + 2, tao / main.getFN());
+	}
+	// NES 相对主结构的位移
+	std::vector<ResponseStatistics> strokes;
+	if (strokeStatistics) {
+		for (int i = 1; i <= nesNumber; i++) {
+			strokes.emplace_back(i + 1, i + nesNumber + 2, resultCalcStartTime, 1, nesNumber + 2);
+		}
+	}
+	std::ofstream cycleOfs;
+	std::unique_ptr<CycleTracker> cycles;
+	if (!cycleOutputFile.empty()) {
+		cycleOfs.open(cycleOutputFile);
+		if (!cycleOfs) {
+			throw std::runtime_error("Cannot open cycle output file \"" + cycleOutputFile + "\".");
+		}
+		cycleOfs << std::setprecision(10);
+		cycles = std::make_unique<CycleTracker>(cycleOfs, main.getFN(), main.getD());
+		cycles->addChannel(1, nesNumber + 2);
+		for (int i = 1; i <= nesNumber; i++) {
+			cycles->addChannel(i + 1, i + nesNumber + 2, 1, nesNumber + 2);
+		}
+		cycles->writeHeader();
+	}
+	std::unique_ptr<PoincareSection> section;
+	if (poincareSection) {
+		section = std::make_unique<PoincareSection>(dimension, nesNumber + 2, resultCalcStartTime,
+			[this](const std::vector<double>& state, std::vector<double>& deriv){ computeDerivatives(state, deriv); });
+	}
+	std::unique_ptr<SpectrumAnalyzer> spectrum;
+	if (spectralAnalysis) {
+		const size_t stride = SpectrumAnalyzer::strideFor(taoStepSize);
+		spectrum = std::make_unique<SpectrumAnalyzer>(resultCalcStartTime, stride);
+		spectrum->addChannel(1);
+		for (int i = 1; i <= nesNumber; i++) {
+			spectrum->addChannel(i + 1, 1);
+		}
+		spectrum->reserve(static_cast<size_t>((totalTime - resultCalcStartTime) / timeStepSize) / stride + 2);
+	}
+	std::unique_ptr<EnergyBalance> energy;
+	if (energyMetrics) {
+		energy = std::make_unique<EnergyBalance>(nesNumber + 2, resultCalcStartTime,
+			[this](const std::vector<double>& state, std::vector<double>& powers){ computePowers(state, powers); });
+	}
+	history.reset();
+	if (keepHistory) {
+		history = std::make_shared<StateHistory>(dimension, static_cast<size_t>(numSteps) + 1, historyDir);
+	}
+	StateHistory* historyBuffer = history.get();
+	const bool writeHistory = !outputFile.empty() && !columnar;
+	std::function<void(const std::vector<double>&)> stepFunction =
+		[&ofs, &columnar, &statistics, &strokes, &cycles, &section, &spectrum, &energy, historyBuffer, writeHistory](const std::vector<double>& state) {
+		if (writeHistory) {
 			for (const auto& val : state) {
 				ofs << std::scientific << std::setprecision(10) << val << "\t";
 			}
 			ofs << "\n";
-			results.push_back(state);
-			};
-	}
-	else {
-		stepFunction =
-			[&results](const std::vector<double>& state) {
-			results.push_back(state);
-			};
-	}
+		}
+		if (columnar) {
+			columnar->update(state);
+		}
+		for (auto& s : statistics) {
+			s.update(state);
+		}
+		for (auto& s : strokes) {
+			s.update(state);
+		}
+		if (cycles) {
+			cycles->update(state);
+		}
+		if (section) {
+			section->update(state);
+		}
+		if (spectrum) {
+			spectrum->update(state);
+		}
+		if (energy) {
+			energy->update(state);
+		}
+		if (historyBuffer) {
+			historyBuffer->push(state);
+		}
+		};
 
-	rk4.setStepFunction(stepFunction);
-	rk4.integrate(state);
+	integrator->setStepFunction(stepFunction);
+    integrator->setDivergenceCheck(1, divergenceAStar * D);
+	integrator->integrate(state);
     ofs.close();
+	if (columnar) {
+		columnar->close();
+	}
+    finalState = state;
+    if(integrator->isDiverged()){
+        DisplacementResults failed{ 0.0, 0.0 };
+        failed.diverged = true;
+        failed.divergedTao = integrator->getCompletedSteps() * taoStepSize;
+        return withWindows(failed);
+    }
     
-	double yRms = getRms(results, 1, resultCalcStartTime) / main.getD();
-	double yMax = getMax(results, 1, resultCalcStartTime) / main.getD();
-	return DisplacementResults{ yRms,yMax };
+	double yRms = statistics[0].getRms() / main.getD();
+	double yMax = statistics[0].getMax() / main.getD();
+	DisplacementResults results{ yRms,yMax };
+	for (size_t i = 1; i < statistics.size(); i++) {
+		results.windowRms.push_back(statistics[i].getRms() / main.getD());
+		results.windowMax.push_back(statistics[i].getMax() / main.getD());
+	}
+	if (section) {
+		results.sectionPoints = section->getPoints();
+	}
+	if (spectrum) {
+		results.spectra = spectrum->analyze(main.getFN());
+	}
+	for (size_t i = 0; i < strokes.size(); i++) {
+		StrokeStatistics stroke;
+		stroke.rms = strokes[i].getRms() / D;
+		stroke.max = strokes[i].getAbsMax() / D;
+		const double z = strokes[i].getAbsMax();
+		stroke.peakForce = nes[i].k * z * z * z;
+		results.strokes.push_back(stroke);
+	}
+	if (energy && energy->getDuration() > 0.0) {
+		const std::vector<double>& e = energy->getEnergies();
+		double dissipated = 0.0;
+		for (size_t i = 1; i < e.size(); i++) {
+			dissipated += e[i];
+		}
+		results.energy.valid = true;
+		results.energy.aeroInput = e[0] / energy->getDuration() / (main.getK() * D * D * 2 * PI * main.getFN());
+		results.energy.structuralFraction = dissipated > 0.0 ? e[1] / dissipated : 0.0;
+		for (size_t i = 2; i < e.size(); i++) {
+			results.energy.nesFractions.push_back(dissipated > 0.0 ? e[i] / dissipated : 0.0);
+		}
+	}
+	return results;
 
 }
 
+void NESSolver::setCase3m3u(size_t i){
+    const double U_stars[3] = { 1.6, 1.7, 1.8 };
+    const double naturalFreq[3] = { 0.1705 / 0.2325 * 1.117, 1.117, 0.3687 / 0.2325 * 1.117 };
+    if(i >= caseNum3m3u){
+        throw std::runtime_error("Case index of 3m3u is out of range.");
+    }
+    setMainFN(naturalFreq[i / 3]);
+    setUStar(U_stars[i % 3]);
+}
 std::vector<DisplacementResults> NESSolver::runConfig3m3u(){
-    double U_stars[3] = { 1.6, 1.7, 1.8 };
-    double naturalFreq[3] = { 0.1705 / 0.2325 * 1.117, 1.117, 0.3687 / 0.2325 * 1.117 };
     std::vector<DisplacementResults> allResults;
-    for (double fn : naturalFreq) {
-        setMainFN(fn);
-        for (double U_star : U_stars) {
-            setUStar(U_star);
-            auto results = run();
-            allResults.push_back(results);
-            
-        }
-        
+    for (size_t i = 0; i < caseNum3m3u; i++) {
+        setCase3m3u(i);
+        auto results = run();
+        allResults.push_back(results);
     }
     if(allResults.size() != 9){
         throw std::runtime_error("Number of results for 3m3u is not 9!");
@@ -202,8 +511,8 @@ void NESSolver::refreshFuncs(){
     double rou = main.getRou();
     double B = main.getB();
     double D = main.getD();
-    double ypDotFactor = PI * rou * B * main.getFR() * B;
-    double ypFactor = 2 * PI * PI * rou * B * B * B * main.getFR() * main.getFR() / D;
+    ypDotFactor = PI * rou * B * main.getFR() * B;
+    ypFactor = 2 * PI * PI * rou * B * B * B * main.getFR() * main.getFR() / D;
     // function 0 t
     funcs.push_back([](const std::vector<double>& state) { return 1; }); // t
     funcs.push_back([this](const std::vector<double>& state) { 
@@ -217,8 +526,8 @@ void NESSolver::refreshFuncs(){
     }
     double invMainM = 1.0 / main.getM();
     double invMainD = 1.0 / main.getD();
-    double invOmega = 1.0 / omega;
-    funcs.push_back([this, invMainM, invMainD, invOmega, ypDotFactor, ypFactor](const std::vector<double>& state){
+    invOmega = 1.0 / omega;
+    funcs.push_back([this, invMainM, invMainD](const std::vector<double>& state){
         double fl;
         double yp = state[1];
         double ypv = state[nesNumber + 2];
@@ -265,6 +574,215 @@ void NESSolver::refreshFuncs(){
         }); // yai_dot_dot
     }
 }
+void NESSolver::computeDerivatives(const std::vector<double>& state, std::vector<double>& deriv) const{
+    const size_t n = nesNumber;
+    const double invMainM = 1.0 / main.getM();
+    const double yp = state[1];
+    const double ypv = state[n + 2];
+    const double currentAStar = std::sqrt(yp * yp + ypv * ypv * invOmega * invOmega) / main.getD();
+    double h1, h4;
+    model.getAeroCoeffs(currentAStar, h1, h4);
+    double force = ypDotFactor * h1 * ypv + ypFactor * h4 * yp
+        - main.getC() * ypv
+        - main.getK() * yp;
+    deriv[0] = 1.0;
+    deriv[1] = ypv;
+    for(size_t i = 1; i <= n; i++){
+        const double z = yp - state[i + 1];
+        const double zv = ypv - state[i + n + 2];
+        const double nesForce = -nes[i-1].c * zv - nes[i-1].k * z * z * z;
+        force += nesForce;
+        deriv[i + 1] = state[i + n + 2];
+        deriv[i + n + 2] = -nesForce * nes[i-1].invM;
+    }
+    deriv[n + 2] = force * invMainM;
+}
+void NESSolver::computePowers(const std::vector<double>& state, std::vector<double>& powers) const{
+    const size_t n = nesNumber;
+    const double yp = state[1];
+    const double ypv = state[n + 2];
+    const double currentAStar = std::sqrt(yp * yp + ypv * ypv * invOmega * invOmega) / main.getD();
+    double h1, h4;
+    model.getAeroCoeffs(currentAStar, h1, h4);
+    powers[0] = (ypDotFactor * h1 * ypv + ypFactor * h4 * yp) * ypv;
+    powers[1] = main.getC() * ypv * ypv;
+    for(size_t i = 1; i <= n; i++){
+        const double zv = ypv - state[i + n + 2];
+        powers[i + 1] = nes[i-1].c * zv * zv;
+    }
+}
+void NESSolver::computeJacobian(const std::vector<double>& state, std::vector<double>& jac) const{
+    const size_t n = nesNumber;
+    const size_t d = dimension;
+    const double invMainM = 1.0 / main.getM();
+    const double D = main.getD();
+    const double yp = state[1];
+    const double ypv = state[n + 2];
+    std::fill(jac.begin(), jac.begin() + d * d, 0.0);
+
+    const double r = std::sqrt(yp * yp + ypv * ypv * invOmega * invOmega);
+    double h1, h4, dh1, dh4;
+    model.getAeroCoeffsAndSlopes(r / D, h1, h4, dh1, dh4);
+    // A* 对 yp / yp_dot 的偏导, 原点处取 0
+    const double dAdyp = r > 0.0 ? yp / (r * D) : 0.0;
+    const double dAdypv = r > 0.0 ? ypv * invOmega * invOmega / (r * D) : 0.0;
+    const double dFl = ypDotFactor * dh1 * ypv + ypFactor * dh4 * yp;
+
+    const size_t rowMain = (n + 2) * d;
+    jac[rowMain + 1] = (ypFactor * h4 + dFl * dAdyp - main.getK()) * invMainM;
+    jac[rowMain + n + 2] = (ypDotFactor * h1 + dFl * dAdypv - main.getC()) * invMainM;
+    jac[1 * d + n + 2] = 1.0;
+    for(size_t i = 1; i <= n; i++){
+        const double z = yp - state[i + 1];
+        const double dStiff = 3.0 * nes[i-1].k * z * z;
+        const double c = nes[i-1].c;
+        const double invM = nes[i-1].invM;
+        // yp_dot_dot
+        jac[rowMain + 1] -= dStiff * invMainM;
+        jac[rowMain + i + 1] += dStiff * invMainM;
+        jac[rowMain + n + 2] -= c * invMainM;
+        jac[rowMain + i + n + 2] += c * invMainM;
+        // yai_dot
+        jac[(i + 1) * d + i + n + 2] = 1.0;
+        // yai_dot_dot
+        const size_t rowNES = (i + n + 2) * d;
+        jac[rowNES + 1] = dStiff * invM;
+        jac[rowNES + i + 1] = -dStiff * invM;
+        jac[rowNES + n + 2] = c * invM;
+        jac[rowNES + i + n + 2] = -c * invM;
+    }
+}
+void NESSolver::computeStructuralMatrix(std::vector<double>& linear) const{
+    const size_t n = nesNumber;
+    const size_t d = dimension;
+    const double invMainM = 1.0 / main.getM();
+    linear.assign(d * d, 0.0);
+    const size_t rowMain = (n + 2) * d;
+    linear[1 * d + n + 2] = 1.0;
+    linear[rowMain + 1] = -main.getK() * invMainM;
+    linear[rowMain + n + 2] = -main.getC() * invMainM;
+    for(size_t i = 1; i <= n; i++){
+        const double c = nes[i-1].c;
+        const double invM = nes[i-1].invM;
+        linear[(i + 1) * d + i + n + 2] = 1.0;
+        linear[rowMain + n + 2] -= c * invMainM;
+        linear[rowMain + i + n + 2] += c * invMainM;
+        const size_t rowNES = (i + n + 2) * d;
+        linear[rowNES + n + 2] = c * invM;
+        linear[rowNES + i + n + 2] = -c * invM;
+    }
+}
+void NESSolver::computeLinearizedJacobian(double aStar, std::vector<double>& jac) const{
+    const size_t n = nesNumber;
+    const size_t d = dimension;
+    // 零点处立方弹簧的切线刚度为 0, 只需把气动系数从 A* = 0 换成 aStar
+    std::vector<double> zero(d, 0.0);
+    computeJacobian(zero, jac);
+    double h1Zero, h4Zero, h1, h4;
+    model.getAeroCoeffs(0.0, h1Zero, h4Zero);
+    model.getAeroCoeffs(aStar, h1, h4);
+    const double invMainM = 1.0 / main.getM();
+    const size_t rowMain = (n + 2) * d;
+    jac[rowMain + 1] += ypFactor * (h4 - h4Zero) * invMainM;
+    jac[rowMain + n + 2] += ypDotFactor * (h1 - h1Zero) * invMainM;
+}
+LinearStability NESSolver::checkLinearStability() const{
+    const size_t d = dimension;
+    const size_t m = d - 1;
+    const double omegaN = 2 * PI * main.getFN();
+    LinearStability result;
+    // H1/H4 为分段线性插值, 在 0 ~ initialAStar 内等距检查
+    const double spacing = result.aStarSpacing;
+    const int sampleNum = static_cast<int>(std::ceil(initialAStar / spacing));
+    result.stable = true;
+    result.growthRate = LinearStability::noOscillation;
+    std::vector<double> jac(d * d), reduced(m * m);
+    for(int s = 0; s <= sampleNum; s++){
+        const double aStar = std::min(s * spacing, initialAStar);
+        computeLinearizedJacobian(aStar, jac);
+        // 去掉时间分量
+        for(size_t i = 1; i < d; i++){
+            for(size_t j = 1; j < d; j++){
+                reduced[(i - 1) * m + (j - 1)] = jac[i * d + j];
+            }
+        }
+        double rate = LinearStability::noOscillation;
+        for(const auto& lambda : eigenvalues(reduced, m)){
+            // NES 无线性刚度, 其位移对应零特征值, 只影响稳定性的判断不计入主结构增长率
+            if(lambda.real() > 1e-9 * omegaN){
+                result.stable = false;
+            }
+            if(std::abs(lambda.imag()) > 0.0 && lambda.real() > rate){
+                rate = lambda.real();
+                if(rate > result.growthRate){
+                    result.growthRate = rate;
+                    result.frequency = std::abs(lambda.imag()) / (2 * PI);
+                    result.criticalAStar = aStar;
+                }
+            }
+        }
+        result.growthRates.push_back(rate);
+    }
+    return result;
+}
+DisplacementResults NESSolver::linearDecayResults(const LinearStability& linear) const{
+    const size_t last = linear.growthRates.size() - 1;
+    auto rateAt = [&linear, last](double aStar){
+        double x = aStar / linear.aStarSpacing;
+        size_t i = std::min(static_cast<size_t>(x), last);
+        if(i == last){
+            return linear.growthRates[last];
+        }
+        double w = x - i;
+        return (1.0 - w) * linear.growthRates[i] + w * linear.growthRates[i + 1];
+    };
+    DisplacementResults decay{ 0.0, 0.0 };
+    decay.prescreened = true;
+    decay.windowRms.assign(extraCalcStartTaos.size(), 0.0);
+    decay.windowMax.assign(extraCalcStartTaos.size(), 0.0);
+    for(double r : linear.growthRates){
+        if(r == LinearStability::noOscillation){
+            return decay;
+        }
+    }
+    // 各统计区间 (主区间在前) 的起点
+    std::vector<double> startTimes{ resultCalcStartTime };
+    for(double tao : extraCalcStartTaos){
+        startTimes.push_back(tao / main.getFN());
+    }
+    std::vector<double> sumSq(startTimes.size(), 0.0), maxA(startTimes.size(), 0.0);
+    std::vector<int> count(startTimes.size(), 0);
+    // 包络随时间单调衰减, 用 0.1 tao 的 RK4 积分
+    const double h = 0.1 / main.getFN();
+    const int steps = static_cast<int>(std::ceil(totalTime / h));
+    auto f = [&rateAt](double a){ return rateAt(a) * a; };
+    double a = initialAStar;
+    for(int i = 0; i <= steps; i++){
+        const double t = i * h;
+        for(size_t w = 0; w < startTimes.size(); w++){
+            if(t >= startTimes[w]){
+                if(count[w] == 0){
+                    maxA[w] = a;
+                }
+                sumSq[w] += 0.5 * a * a;
+                count[w]++;
+            }
+        }
+        double k1 = f(a);
+        double k2 = f(a + 0.5 * h * k1);
+        double k3 = f(a + 0.5 * h * k2);
+        double k4 = f(a + h * k3);
+        a = std::max(a + h / 6.0 * (k1 + 2 * k2 + 2 * k3 + k4), 0.0);
+    }
+    auto rms = [&](size_t w){ return count[w] > 0 ? std::sqrt(sumSq[w] / count[w]) : 0.0; };
+    decay.yRms = rms(0);
+    decay.yMax = maxA[0];
+    for(size_t w = 1; w < startTimes.size(); w++){
+        decay.windowRms[w - 1] = rms(w);
+        decay.windowMax[w - 1] = maxA[w];
+    }
+    return decay;
+}
 void NESSolver::refreshNES(){
     for(auto& n : nes){
         n.m = main.getM() * n.mr;
@@ -298,6 +816,11 @@ void NESSolver::printAll() const{
     std::cout << "taoStepSize: " << taoStepSize << std::endl;
     std::cout << "totalTao: " << totalTao << std::endl;
     std::cout << "resultCalcStartTao: " << resultCalcStartTao << std::endl;
+    std::cout << "extraCalcStartTaos:";
+    for(double tao : extraCalcStartTaos){
+        std::cout << " " << tao;
+    }
+    std::cout << std::endl;
     std::cout << "timeStepSize: " << timeStepSize << std::endl;
     std::cout << "totalTime: " << totalTime << std::endl;
     std::cout << "resultCalcStartTime: " << resultCalcStartTime << std::endl;
@@ -305,6 +828,24 @@ void NESSolver::printAll() const{
     std::cout << "kDesign: " << kDesign << std::endl;
     std::cout << "cDesign: " << cDesign << std::endl;
     std::cout << "outputFile: " << outputFile << std::endl;
+    std::cout << "cycleOutputFile: " << cycleOutputFile << std::endl;
+    std::cout << "poincareSection: " << poincareSection << std::endl;
+    std::cout << "spectralAnalysis: " << spectralAnalysis << std::endl;
+    std::cout << "energyMetrics: " << energyMetrics << std::endl;
+    std::cout << "strokeStatistics: " << strokeStatistics << std::endl;
+    std::cout << "divergenceAStar: " << divergenceAStar << std::endl;
+    std::cout << "method: " << (method == SolverMethod::Shooting ? "shooting" :
+        method == SolverMethod::HarmonicBalance ? "hb (H = " + std::to_string(harmonicNumber) + ")" :
+        method == SolverMethod::SlowFlow ? "slow" : "time") << std::endl;
+    std::cout << "slowFlowStart: " << slowFlowStart << std::endl;
+    std::cout << "linearPrescreen: " << linearPrescreen << std::endl;
+    std::cout << "integrator: " << (integratorType == IntegratorType::Ros2 ? "ros2" :
+        integratorType == IntegratorType::Rodas3 ? "rodas3" :
+        integratorType == IntegratorType::ETDRK4 ? "etdrk4" :
+        integratorType == IntegratorType::LowStorage4 ? "ck4" :
+        integratorType == IntegratorType::Tsit5 ? "tsit5" :
+        integratorType == IntegratorType::Butcher6 ? "butcher6" :
+        integratorType == IntegratorType::CooperVerner8 ? "cv8" : "rk4") << std::endl;
     int i = 1;
     std::cout << "-------------------NES parameters------------------" << std::endl;
     for(auto n : nes){
@@ -1,6 +1,15 @@
 #include "NESSweeper.h"
+#include "PoincareSection.h"
 #include <algorithm>
 #include <fstream>
+#include <cmath>
+#include <chrono>
+#include <thread>
+#include <mutex>
+#include <atomic>
+#include <exception>
+#include <map>
+#include <sstream>
 
 NESSweeper::NESSweeper(NESSolver& solver_, std::string sweepParamsFile_, double totalMassRatio_)
 :solver(solver_), 
@@ -185,77 +194,746 @@ void NESSweeper::printConfigs(){
     std::cout << "Total configurations generated: " << configIndex << std::endl;
 }
 
-void NESSweeper::run(){
-    std::ofstream ofs(outFile);
-    if (!ofs) {
-        throw std::runtime_error("Cannot open out file \"" + outFile + "\".");
+static std::string formatDuration(double seconds){
+    long long total = static_cast<long long>(seconds + 0.5);
+    std::ostringstream oss;
+    oss << std::setfill('0') << std::setw(2) << total / 3600 << ":"
+        << std::setw(2) << (total / 60) % 60 << ":"
+        << std::setw(2) << total % 60;
+    return oss.str();
+}
+// 擦除 SweepProgress 的当前行, 之后的输出从行首开始
+static void clearProgressLine(){
+    std::cout << "\r" << std::string(100, ' ') << "\r";
+}
+// 单行刷新的进度显示 (吞吐量与剩余时间), 每秒最多刷新一次
+class SweepProgress{
+public:
+    SweepProgress(const std::string& stage_, size_t total_):
+    stage(stage_), total(total_), start(std::chrono::steady_clock::now()), lastPrint(start){}
+    void update(size_t done){
+        auto now = std::chrono::steady_clock::now();
+        if(done < total && now - lastPrint < std::chrono::seconds(1)){
+            return;
+        }
+        lastPrint = now;
+        double elapsed = std::chrono::duration<double>(now - start).count();
+        double throughput = elapsed > 0.0 ? done / elapsed : 0.0;
+        double eta = throughput > 0.0 ? (total - done) / throughput : 0.0;
+        std::cout << "\r" << stage << ": " 
+        << std::fixed << std::setprecision(1) << static_cast<double>(done) / total * 100.0 << "% (" 
+        << done << "/" << total << "), " 
+        << std::setprecision(2) << throughput << " configs/s, ETA " << formatDuration(eta) 
+        << std::defaultfloat << "    " << std::flush;
     }
-    ofs << std::scientific << std::setprecision(8);
+    void finish(){
+        double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        std::cout << "\n" << stage << " finished in " << formatDuration(elapsed) << "." << std::endl;
+    }
+private:
+    std::string stage;
+    size_t total;
+    std::chrono::steady_clock::time_point start;
+    std::chrono::steady_clock::time_point lastPrint;
+};
+
+std::vector<SweepConfig> NESSweeper::collectConfigs() const{
+    std::vector<SweepConfig> configs;
     if(nesNum == 1){
-        solver.setNESMr(1, totalMassRatio);
-        ofs << "kr,cr,m1u1,m1u2,m1u3,m2u1,m2u2,m2u3,m3u1,m3u2,m3u3" << std::endl;
-        double configNum =  static_cast<double>(krDatas[0].size() * crDatas[0].size());
-        int i = 0;
         for(const double kr : krDatas[0]){
             for(const double cr : crDatas[0]){
-                solver.setNESKr(1, kr);
-                solver.setNESCr(1, cr);
-                auto result = solver.runConfig3m3u();
-                ofs << kr << "," << cr ;
-                for(const auto& r : result){
-                    ofs << "," << r.yRms ;
-                }
-                ofs << "\n";
-                i++;
-                std::cout << "Progress: " << static_cast<double>(i) / configNum * 100.0 << "%" <<std::endl;
+                configs.push_back(SweepConfig{{totalMassRatio}, {kr}, {cr}});
             }
-            
         }
-
     }
     else if(nesNum == 2){
-        solver.setNESMr(2, totalMassRatio);
-        ofs << "mr1,kr1,cr1,mr2,kr2,cr2,m1u1,m1u2,m1u3,m2u1,m2u2,m2u3,m3u1,m3u2,m3u3" << std::endl;
-        double configNum =  static_cast<double>(
-            mrDatas[0].size() *
-            krDatas[0].size() * crDatas[0].size() *
-            krDatas[1].size() * crDatas[1].size()
-        );
-        int i = 0;
         for(const double mr1 : mrDatas[0])
         for(const double kr1 : krDatas[0])
         for(const double cr1 : crDatas[0])
         for(const double kr2 : krDatas[1])
         for(const double cr2 : crDatas[1]){
             double mr2 = totalMassRatio - mr1;
-            solver.setNESMr(1, mr1);
-            solver.setNESKr(1, kr1);
-            solver.setNESCr(1, cr1);
-            solver.setNESMr(2, mr2);
-            solver.setNESKr(2, kr2);
-            solver.setNESCr(2, cr2);
-            auto result = solver.runConfig3m3u();
-            ofs 
-            << mr1 << "," 
-            << kr1 << "," 
-            << cr1 << "," 
-            << mr2 << "," 
-            << kr2 << "," 
-            << cr2  ;
-            
-            for(const auto& r : result){
-                ofs << "," << r.yRms ;
+            // 质量必须大于 0 (使用一个小容差防止浮点误差)
+            if(mr2 <= 1e-9){
+                continue;
             }
-            ofs << "\n";
-            i++;
-            std::cout << "Progress: " << static_cast<double>(i) / configNum * 100.0 << "%" <<std::endl;
+            configs.push_back(SweepConfig{{mr1, mr2}, {kr1, kr2}, {cr1, cr2}});
         }
-            
-        
     }else{
         throw std::runtime_error("Nes number > 2 is not supported for sweeping.");
     }
-    ofs.close();
+    return configs;
+}
+std::vector<DisplacementResults> NESSweeper::evaluate(NESSolver& s, const SweepConfig& config, WarmStart* warm){
+    for(size_t i = 1; i <= static_cast<size_t>(nesNum); i++){
+        s.setNESMr(i, config.mr[i-1]);
+        s.setNESKr(i, config.kr[i-1]);
+        s.setNESCr(i, config.cr[i-1]);
+    }
+    if(warm == nullptr){
+        return s.runConfig3m3u();
+    }
+    // 续算: 以相邻配置同一工况的末状态为初值, 过渡段缩短为 warmCalcStartTao, 统计区间长度不变
+    const double totalTao = s.getTotalTao();
+    const double calcStartTao = s.getResultCalcStartTao();
+    const double warmStartTao = std::min(warmCalcStartTao, calcStartTao);
+    // 附加统计区间随过渡段一起前移, 起点早于续算初值的从初值开始统计
+    const std::vector<double> extraTaos = s.getExtraCalcStartTaos();
+    std::vector<double> warmExtraTaos;
+    for(double tao : extraTaos){
+        warmExtraTaos.push_back(std::max(tao - calcStartTao + warmStartTao, 0.0));
+    }
+    // 定期与冷启动对照, 确认续算没有换到另一个吸引子
+    const bool check = warm->valid && warmCheckInterval > 0 && ++warm->sinceCheck >= warmCheckInterval;
+    bool mismatched = false;
+    bool compared = false;
+    warm->pending = false;
+    warm->checkPassed = false;
+    warm->checkFailed = false;
+    std::vector<DisplacementResults> results;
+    std::vector<std::vector<double>> states;
+    for(size_t c = 0; c < NESSolver::caseNum3m3u; c++){
+        s.setCase3m3u(c);
+        bool accepted = false;
+        DisplacementResults r{0.0, 0.0};
+        if(warm->valid){
+            s.setInitialState(warm->states[c]);
+            s.setTotalTao(totalTao - calcStartTao + warmStartTao);
+            s.setResultCalcStartTao(warmStartTao);
+            s.setExtraCalcStartTaos(warmExtraTaos);
+            r = s.run();
+            s.clearInitialState();
+            s.setTotalTao(totalTao);
+            s.setResultCalcStartTao(calcStartTao);
+            s.setExtraCalcStartTaos(extraTaos);
+            // 响应与相邻配置相差过大时认为吸引子发生了变化, 改为冷启动
+            const auto& prev = warm->results[c];
+            double scale = std::max(std::max(prev.yRms, r.yRms), 1e-4);
+            accepted = !r.diverged && std::abs(r.yRms - prev.yRms) <= warmTolerance * scale;
+            (accepted ? warmAccepted : warmRejected)++;
+        }
+        if(accepted && check){
+            DisplacementResults cold = s.run();
+            compared = true;
+            if(!sameResponse(r, cold)){
+                mismatched = true;
+            }
+            r = cold;
+        }
+        else if(!accepted){
+            r = s.run();
+        }
+        else if(warmCheckInterval > 0){
+            warm->pending = true;
+        }
+        results.push_back(r);
+        states.push_back(s.getFinalState());
+    }
+    // 本配置的续算全部被拒绝时没有可对照的结果, 下一个配置再对照
+    if(compared){
+        warmChecked++;
+        warm->sinceCheck = 0;
+        if(mismatched){
+            warmMismatched++;
+            warm->disabled = true;
+        }
+        warm->checkPassed = !mismatched;
+        warm->checkFailed = mismatched;
+    }
+    warm->valid = !warm->disabled && !anyDiverged(results);
+    warm->states = states;
+    warm->results = results;
+    return results;
+}
+bool NESSweeper::sameResponse(const DisplacementResults& warm, const DisplacementResults& cold) const{
+    if(cold.diverged || warm.diverged){
+        return cold.diverged == warm.diverged;
+    }
+    double scale = std::max(std::max(cold.yRms, warm.yRms), 1e-4);
+    return std::abs(warm.yRms - cold.yRms) <= warmTolerance * scale;
+}
+std::vector<std::vector<size_t>> NESSweeper::groupTasks(const std::vector<SweepConfig>& configs, const std::vector<size_t>& indices) const{
+    std::vector<std::vector<size_t>> tasks;
+    if(!warmStart){
+        for(const size_t idx : indices){
+            tasks.push_back({idx});
+        }
+        return tasks;
+    }
+    // 续算时同一扫描线 (只有最后一个 cr 不同) 上的配置必须由同一线程依次计算
+    auto sameLine = [&configs, this](size_t a, size_t b){
+        const auto& ca = configs[a];
+        const auto& cb = configs[b];
+        return ca.mr == cb.mr && ca.kr == cb.kr 
+            && std::equal(ca.cr.begin(), ca.cr.begin() + (nesNum - 1), cb.cr.begin());
+    };
+    for(const size_t idx : indices){
+        if(tasks.empty() || !sameLine(tasks.back().back(), idx)){
+            tasks.push_back({});
+        }
+        tasks.back().push_back(idx);
+    }
+    return tasks;
+}
+std::vector<double> NESSweeper::evaluateAll(
+    const std::vector<SweepConfig>& configs,
+    const std::vector<size_t>& indices,
+    const std::vector<double>& estimatedCosts,
+    const std::string& stage,
+    const ResultCallback& onResult
+){
+    auto tasks = groupTasks(configs, indices);
+    std::vector<double> taskCosts(tasks.size(), 0.0);
+    for(size_t t = 0; t < tasks.size(); t++){
+        for(const size_t idx : tasks[t]){
+            taskCosts[t] += estimatedCosts[idx];
+        }
+    }
+    // 最长优先调度: 预计耗时长的任务先分发, 减少末尾线程空等
+    std::vector<size_t> order(tasks.size());
+    for(size_t t = 0; t < order.size(); t++){
+        order[t] = t;
+    }
+    std::stable_sort(order.begin(), order.end(), [&taskCosts](size_t a, size_t b){
+        return taskCosts[a] > taskCosts[b];
+    });
+    std::vector<double> seconds(configs.size(), 0.0);
+    std::atomic<size_t> next{0};
+    std::mutex mtx;
+    std::exception_ptr error;
+    size_t done = 0;
+    SweepProgress progress(stage, indices.size());
+
+    auto worker = [&](){
+        // 每个线程使用独立的求解器副本
+        NESSolver local(solver);
+        local.refreshAll();
+        while(true){
+            size_t k = next++;
+            if(k >= order.size()){
+                break;
+            }
+            WarmStart warm;
+            // 未经冷启动对照的续算结果先保留, 对照通过后输出, 不通过则冷启动重算
+            struct HeldResult{
+                size_t idx;
+                std::vector<DisplacementResults> results;
+                double seconds;
+            };
+            std::vector<HeldResult> held;
+            auto timed = [&](size_t idx, WarmStart* w, double& elapsed){
+                auto t0 = std::chrono::steady_clock::now();
+                auto result = evaluate(local, configs[idx], w);
+                elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+                return result;
+            };
+            auto deliver = [&](size_t idx, const std::vector<DisplacementResults>& result, double elapsed){
+                std::lock_guard<std::mutex> lock(mtx);
+                seconds[idx] = elapsed;
+                onResult(idx, result);
+                progress.update(++done);
+            };
+            auto release = [&](){
+                for(const auto& h : held){
+                    deliver(h.idx, h.results, h.seconds);
+                }
+                held.clear();
+            };
+            auto redoCold = [&](){
+                for(const auto& h : held){
+                    double elapsed = 0.0;
+                    auto cold = timed(h.idx, nullptr, elapsed);
+                    deliver(h.idx, cold, h.seconds + elapsed);
+                }
+                warmRedone += held.size();
+                held.clear();
+            };
+            try{
+                for(const size_t idx : tasks[order[k]]){
+                    double elapsed = 0.0;
+                    auto result = timed(idx, warmStart ? &warm : nullptr, elapsed);
+                    if(warm.checkFailed){
+                        redoCold();
+                    }
+                    else if(warm.checkPassed){
+                        release();
+                    }
+                    if(warm.pending){
+                        held.push_back(HeldResult{idx, result, elapsed});
+                    }
+                    else{
+                        deliver(idx, result, elapsed);
+                    }
+                }
+                // 扫描线末尾的续算结果没有后续对照: 以最后一个配置的冷启动结果对照
+                if(!held.empty()){
+                    HeldResult last = held.back();
+                    held.pop_back();
+                    double elapsed = 0.0;
+                    auto cold = timed(last.idx, nullptr, elapsed);
+                    warmChecked++;
+                    bool same = true;
+                    for(size_t c = 0; c < cold.size(); c++){
+                        same = same && sameResponse(last.results[c], cold[c]);
+                    }
+                    if(same){
+                        release();
+                    }
+                    else{
+                        warmMismatched++;
+                        redoCold();
+                    }
+                    deliver(last.idx, cold, last.seconds + elapsed);
+                }
+            }
+            catch(...){
+                std::lock_guard<std::mutex> lock(mtx);
+                if(!error){
+                    error = std::current_exception();
+                }
+                next = order.size();
+                break;
+            }
+        }
+    };
+    size_t workerNum = std::min<size_t>(threadNum, order.size());
+    if(workerNum <= 1){
+        worker();
+    }
+    else{
+        std::vector<std::thread> threads;
+        for(size_t i = 0; i < workerNum; i++){
+            threads.emplace_back(worker);
+        }
+        for(auto& t : threads){
+            t.join();
+        }
+    }
+    if(error){
+        std::cout << std::endl;
+        std::rethrow_exception(error);
+    }
+    progress.finish();
+    return seconds;
+}
+double NESSweeper::calibrate(const SweepConfig& config){
+    NESSolver local(solver);
+    const double calibTao = std::min(solver.getTotalTao(), 5.0);
+    local.setTotalTao(calibTao);
+    local.setResultCalcStartTao(0.0);
+    // 标定的是时域积分的单步耗时
+    local.setMethod(SolverMethod::TimeDomain);
+    local.setPoincareSection(false);
+    local.setSpectralAnalysis(false);
+    local.setLinearPrescreen(false);
+    for(size_t i = 1; i <= static_cast<size_t>(nesNum); i++){
+        local.setNESMr(i, config.mr[i-1]);
+        local.setNESKr(i, config.kr[i-1]);
+        local.setNESCr(i, config.cr[i-1]);
+    }
+    auto t0 = std::chrono::steady_clock::now();
+    auto result = local.run();
+    double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+    double tao = result.diverged ? result.divergedTao : calibTao;
+    double steps = std::max(tao / solver.getTaoStepSize(), 1.0);
+    return elapsed / steps;
+}
+void NESSweeper::printEstimate(size_t configNum, double secondsPerStep) const{
+    // 每个配置计算 3 个模态 x 3 个 U*
+    const double runsPerConfig = 9.0;
+    std::cout << "Total valid configurations: " << configNum << std::endl;
+    std::cout << "Calibration: " << secondsPerStep * 1e9 << " ns per step." << std::endl;
+    double total = 0.0;
+    double n = static_cast<double>(configNum);
+    for(size_t level = 0; level < fidelityLevels.size(); level++){
+        const auto& f = fidelityLevels[level];
+        // 非时域积分的近似方法耗时按步数无法估计, 且远小于时域积分, 记为 0
+        double cost = f.method == SolverMethod::TimeDomain ? n * runsPerConfig * f.totalTao / f.taoStepSize * secondsPerStep : 0.0;
+        std::cout << "Screening level " << level + 1 << " (tao = " << f.totalTao << ", dtao = " << f.taoStepSize << "): "
+        << static_cast<size_t>(n) << " configurations, " << formatDuration(cost / threadNum) << std::endl;
+        total += cost;
+        n = std::min(std::max(std::ceil(f.keepRatio * n), 1.0), n);
+    }
+    double cost = n * runsPerConfig * solver.getTotalTao() / solver.getTaoStepSize() * secondsPerStep;
+    std::cout << "Full evaluation (tao = " << solver.getTotalTao() << ", dtao = " << solver.getTaoStepSize() << "): "
+    << static_cast<size_t>(n) << " configurations, " << formatDuration(cost / threadNum) << std::endl;
+    total += cost;
+    std::cout << "Estimated wall time with " << threadNum << " thread(s): " << formatDuration(total / threadNum) << std::endl;
+}
+std::vector<size_t> NESSweeper::screen(const std::vector<SweepConfig>& configs, std::vector<double>& costs){
+    std::vector<size_t> candidates(configs.size());
+    for(size_t i = 0; i < candidates.size(); i++){
+        candidates[i] = i;
+    }
+    if(fidelityLevels.empty()){
+        return candidates;
+    }
+    const double fullTotalTao = solver.getTotalTao();
+    const double fullStepSize = solver.getTaoStepSize();
+    const double fullCalcStartTao = solver.getResultCalcStartTao();
+    const SolverMethod fullMethod = solver.getMethod();
+    // 筛选只用主统计区间, 不记录截面点, 不做频谱分析
+    const std::vector<double> extraTaos = solver.getExtraCalcStartTaos();
+    const bool section = solver.isPoincareSection();
+    const bool spectral = solver.isSpectralAnalysis();
+    solver.setExtraCalcStartTaos({});
+    solver.setPoincareSection(false);
+    solver.setSpectralAnalysis(false);
+    // 统计区间占总时长的比例在各级之间保持不变
+    const double calcStartFraction = fullCalcStartTao / fullTotalTao;
+
+    for(size_t level = 0; level < fidelityLevels.size(); level++){
+        const auto& f = fidelityLevels[level];
+        solver.setTotalTao(f.totalTao);
+        solver.setResultCalcStartTao(f.totalTao * calcStartFraction);
+        solver.setTaoStepSize(f.taoStepSize);
+        solver.setMethod(f.method);
+
+        std::vector<std::pair<double, size_t>> scores;
+        scores.reserve(candidates.size());
+        auto seconds = evaluateAll(configs, candidates, costs, "Screening level " + std::to_string(level + 1),
+            [this, &scores](size_t idx, const std::vector<DisplacementResults>& result){
+                // 发散或超出行程约束的配置排在最后
+                double score = isFeasible(result) ? getObjective(result, objective) : std::numeric_limits<double>::max();
+                scores.emplace_back(score, idx);
+            });
+        // 下一级的预计耗时按本级实测耗时和步数之比缩放
+        double nextSteps = (level + 1 < fidelityLevels.size()) 
+            ? fidelityLevels[level + 1].totalTao / fidelityLevels[level + 1].taoStepSize
+            : fullTotalTao / fullStepSize;
+        double stepRatio = nextSteps / (f.totalTao / f.taoStepSize);
+        if(f.method == SolverMethod::TimeDomain){
+            for(const size_t idx : candidates){
+                costs[idx] = seconds[idx] * stepRatio;
+            }
+        }
+
+        size_t keepNum = static_cast<size_t>(std::ceil(f.keepRatio * scores.size()));
+        keepNum = std::min(std::max<size_t>(keepNum, 1), scores.size());
+        std::partial_sort(scores.begin(), scores.begin() + keepNum, scores.end());
+        candidates.clear();
+        for(size_t i = 0; i < keepNum; i++){
+            candidates.push_back(scores[i].second);
+        }
+        // 保持原始扫描顺序
+        std::sort(candidates.begin(), candidates.end());
+        std::cout << "Screening level " << level + 1 
+        << " (tao = " << f.totalTao << ", dtao = " << f.taoStepSize << "): "
+        << scores.size() << " evaluated, " << keepNum << " kept." << std::endl;
+    }
+
+    solver.setTotalTao(fullTotalTao);
+    solver.setResultCalcStartTao(fullCalcStartTao);
+    solver.setTaoStepSize(fullStepSize);
+    solver.setMethod(fullMethod);
+    solver.setExtraCalcStartTaos(extraTaos);
+    solver.setPoincareSection(section);
+    solver.setSpectralAnalysis(spectral);
+    return candidates;
+}
+std::string NESSweeper::paramHeader() const{
+    if(nesNum == 1){
+        return "kr,cr";
+    }
+    return "mr1,kr1,cr1,mr2,kr2,cr2";
+}
+bool NESSweeper::isFeasible(const std::vector<DisplacementResults>& result) const{
+    return !anyDiverged(result) && !exceedsStroke(result, strokeLimit);
+}
+std::vector<double> NESSweeper::paramValues(const SweepConfig& config) const{
+    if(nesNum == 1){
+        return { config.kr[0], config.cr[0] };
+    }
+    return { config.mr[0], config.kr[0], config.cr[0], config.mr[1], config.kr[1], config.cr[1] };
+}
+std::string NESSweeper::paramLabel(const SweepConfig& config) const{
+    std::ostringstream oss;
+    oss << std::scientific << std::setprecision(8);
+    if(nesNum == 1){
+        oss << config.kr[0] << "," << config.cr[0] ;
+    }
+    else{
+        oss 
+        << config.mr[0] << "," 
+        << config.kr[0] << "," 
+        << config.cr[0] << "," 
+        << config.mr[1] << "," 
+        << config.kr[1] << "," 
+        << config.cr[1]  ;
+    }
+    return oss.str();
+}
+
+void NESSweeper::run(){
+    // outFile 为空时不写完整的扫描结果, 只输出前沿和前 K 名
+    std::ofstream ofs;
+    if(!outFile.empty()){
+        ofs.open(outFile);
+        if (!ofs) {
+            throw std::runtime_error("Cannot open out file \"" + outFile + "\".");
+        }
+    }
+    auto configs = collectConfigs();
+    if(configs.empty()){
+        throw std::runtime_error("No valid configuration to sweep.");
+    }
+    if(ofs.is_open()){
+        ofs << std::scientific << std::setprecision(8);
+        ofs << paramHeader() 
+        << ",m1u1,m1u2,m1u3,m2u1,m2u2,m2u3,m3u1,m3u2,m3u3"
+        << ",m1u1_max,m1u2_max,m1u3_max,m2u1_max,m2u2_max,m2u3_max,m3u1_max,m3u2_max,m3u3_max";
+        // 附加统计区间: 每个区间 9 列 RMS 和 9 列最大值, 列名带区间起点
+        for(double tao : solver.getExtraCalcStartTaos()){
+            std::ostringstream suffix;
+            suffix << "_rc" << tao;
+            for(const char* stat : {"", "_max"}){
+                for(int m = 1; m <= 3; m++){
+                    for(int u = 1; u <= 3; u++){
+                        ofs << ",m" << m << "u" << u << suffix.str() << stat;
+                    }
+                }
+            }
+        }
+        // 频谱特征: 每个工况依次为主结构 (p) 和各 NES 相对位移 (a1, a2) 的 4 个特征
+        if(solver.isSpectralAnalysis()){
+            for(int m = 1; m <= 3; m++){
+                for(int u = 1; u <= 3; u++){
+                    for(int c = 0; c <= nesNum; c++){
+                        std::string channel = c == 0 ? "p" : "a" + std::to_string(c);
+                        for(const char* feature : {"fdom", "sub", "super", "mod"}){
+                            ofs << ",m" << m << "u" << u << "_" << channel << "_" << feature;
+                        }
+                    }
+                }
+            }
+        }
+        // 能量平衡: 每个工况依次为气动输入, 主结构阻尼耗散占比和各 NES 阻尼耗散占比
+        if(solver.isEnergyMetrics()){
+            for(int m = 1; m <= 3; m++){
+                for(int u = 1; u <= 3; u++){
+                    ofs << ",m" << m << "u" << u << "_aero,m" << m << "u" << u << "_struct";
+                    for(int c = 1; c <= nesNum; c++){
+                        ofs << ",m" << m << "u" << u << "_nes" << c;
+                    }
+                }
+            }
+        }
+        // 行程: 每个工况依次为各 NES 的行程 RMS, 最大行程和弹簧力峰值
+        if(solver.isStrokeStatistics()){
+            for(int m = 1; m <= 3; m++){
+                for(int u = 1; u <= 3; u++){
+                    for(int c = 1; c <= nesNum; c++){
+                        std::string prefix = ",m" + std::to_string(m) + "u" + std::to_string(u) + "_nes" + std::to_string(c);
+                        ofs << prefix << "_stroke" << prefix << "_stroke_max" << prefix << "_force";
+                    }
+                }
+            }
+        }
+        // 非时域方法: 每个工况依次为实际采用的方法, 周期 (tao) 和 Floquet 乘子最大模
+        if(solver.getMethod() != SolverMethod::TimeDomain){
+            for(int m = 1; m <= 3; m++){
+                for(int u = 1; u <= 3; u++){
+                    std::string prefix = ",m" + std::to_string(m) + "u" + std::to_string(u);
+                    ofs << prefix << "_method" << prefix << "_period" << prefix << "_floquet";
+                }
+            }
+        }
+        ofs << ",diverged" << std::endl;
+    }
+
+    std::ofstream sectionOfs;
+    if(!poincareFile.empty()){
+        sectionOfs.open(poincareFile, poincareBinary ? std::ios::binary : std::ios::out);
+        if(!sectionOfs){
+            throw std::runtime_error("Cannot open Poincare section file \"" + poincareFile + "\".");
+        }
+        if(!poincareBinary){
+            sectionOfs << paramHeader() << ",case," << stateHeader(nesNum) << "\n";
+        }
+        solver.setPoincareSection(true);
+    }
+
+    ParetoFront front({"yRms", "yMax", "totalMassRatio"}, paramHeader());
+    if(!paretoFile.empty()){
+        front.load(paretoFile);
+        front.write(paretoFile);
+    }
+    TopKTracker topK(std::max<size_t>(topKNum, 1), paramHeader());
+
+    double secondsPerStep = calibrate(configs.front());
+    printEstimate(configs.size(), secondsPerStep);
+    const double runsPerConfig = 9.0;
+    double firstSteps = fidelityLevels.empty() 
+        ? solver.getTotalTao() / solver.getTaoStepSize()
+        : fidelityLevels.front().totalTao / fidelityLevels.front().taoStepSize;
+    std::vector<double> costs(configs.size(), runsPerConfig * firstSteps * secondsPerStep);
+
+    auto candidates = screen(configs, costs);
+    // 前 K 名表格最多打印约 10 次, 小规模扫描只在结束时打印
+    size_t printInterval = std::max<size_t>(candidates.size() / 10, 10);
+    std::vector<size_t> sortedCandidates(candidates);
+    std::sort(sortedCandidates.begin(), sortedCandidates.end());
+    std::vector<size_t> rowOrder(configs.size(), 0);
+    for(size_t k = 0; k < sortedCandidates.size(); k++){
+        rowOrder[sortedCandidates[k]] = k;
+    }
+    std::map<size_t, std::pair<std::string, std::string>> pendingRows;
+    size_t nextRow = 0;
+    size_t i = 0;
+    size_t divergedNum = 0;
+    size_t strokeViolatedNum = 0;
+    size_t prescreenedNum = 0;
+    evaluateAll(configs, candidates, costs, "Progress",
+        [&](size_t idx, const std::vector<DisplacementResults>& result){
+        std::string label = paramLabel(configs[idx]);
+        bool diverged = anyDiverged(result);
+        std::ostringstream row, section;
+        if(ofs.is_open()){
+            row << std::scientific << std::setprecision(8);
+            row << label;
+            // 发散工况的 yRms/yMax 没有意义, 写作 inf
+            for(const auto& r : result){
+                if(r.diverged){ row << ",inf"; } else { row << "," << r.yRms; }
+            }
+            for(const auto& r : result){
+                if(r.diverged){ row << ",inf"; } else { row << "," << r.yMax; }
+            }
+            for(size_t w = 0; w < solver.getExtraCalcStartTaos().size(); w++){
+                for(const auto& r : result){
+                    if(r.diverged){ row << ",inf"; } else { row << "," << r.windowRms[w]; }
+                }
+                for(const auto& r : result){
+                    if(r.diverged){ row << ",inf"; } else { row << "," << r.windowMax[w]; }
+                }
+            }
+            if(solver.isSpectralAnalysis()){
+                for(const auto& r : result){
+                    // 非时域方法和发散的工况没有频谱
+                    for(size_t c = 0; c <= static_cast<size_t>(nesNum); c++){
+                        if(c < r.spectra.size()){
+                            const auto& f = r.spectra[c];
+                            row << "," << f.dominantFrequency << "," << f.subharmonicFraction
+                            << "," << f.superharmonicFraction << "," << f.modulationIndex;
+                        }
+                        else{
+                            row << ",nan,nan,nan,nan";
+                        }
+                    }
+                }
+            }
+            if(solver.isEnergyMetrics()){
+                for(const auto& r : result){
+                    if(r.energy.valid){
+                        row << "," << r.energy.aeroInput << "," << r.energy.structuralFraction;
+                        for(double f : r.energy.nesFractions){
+                            row << "," << f;
+                        }
+                    }
+                    else{
+                        for(int c = 0; c < nesNum + 2; c++){
+                            row << ",nan";
+                        }
+                    }
+                }
+            }
+            if(solver.isStrokeStatistics()){
+                for(const auto& r : result){
+                    for(size_t c = 0; c < static_cast<size_t>(nesNum); c++){
+                        if(c < r.strokes.size()){
+                            row << "," << r.strokes[c].rms << "," << r.strokes[c].max << "," << r.strokes[c].peakForce;
+                        }
+                        else{
+                            row << ",nan,nan,nan";
+                        }
+                    }
+                }
+            }
+            if(solver.getMethod() != SolverMethod::TimeDomain){
+                for(const auto& r : result){
+                    // 改用时域积分的工况记作 time*, 没有周期解的写 nan
+                    row << "," << r.method << (r.fallback ? "*" : "");
+                    if(r.periodTao > 0.0){
+                        row << "," << r.periodTao << "," << r.maxFloquet;
+                    }
+                    else{
+                        row << ",nan,nan";
+                    }
+                }
+            }
+            row << "," << std::count_if(result.begin(), result.end(), [](const DisplacementResults& r){ return r.diverged; });
+            row << "\n";
+        }
+        if(sectionOfs.is_open()){
+            std::vector<double> prefix = paramValues(configs[idx]);
+            prefix.push_back(0.0);
+            for(size_t c = 0; c < result.size(); c++){
+                prefix.back() = static_cast<double>(c);
+                writeSectionPoints(section, prefix, result[c].sectionPoints, solver.getDimension(), poincareBinary);
+            }
+        }
+        // 多线程时结果按完成顺序到达: 先缓存, 按配置序号顺序写出, 输出与线程数无关
+        pendingRows.emplace(rowOrder[idx], std::make_pair(row.str(), section.str()));
+        while(!pendingRows.empty() && pendingRows.begin()->first == nextRow){
+            if(ofs.is_open()){
+                ofs << pendingRows.begin()->second.first;
+            }
+            if(sectionOfs.is_open()){
+                sectionOfs << pendingRows.begin()->second.second;
+            }
+            pendingRows.erase(pendingRows.begin());
+            nextRow++;
+        }
+        if(diverged){
+            divergedNum++;
+        }
+        const bool feasible = isFeasible(result);
+        if(!diverged && !feasible){
+            strokeViolatedNum++;
+        }
+        prescreenedNum += std::count_if(result.begin(), result.end(), [](const DisplacementResults& r){ return r.prescreened; });
+        if(feasible && !paretoFile.empty()){
+            double jYRms, jYMax;
+            get_avg_max(result, jYRms, jYMax);
+            if(front.insert({jYRms, jYMax, totalMassRatio}, label)){
+                front.write(paretoFile);
+            }
+        }
+        if(feasible && topKNum > 0){
+            topK.insert(getObjective(result, objective), label);
+        }
+        i++;
+        if(topKNum > 0 && (i % printInterval == 0 || i == candidates.size())){
+            clearProgressLine();
+            std::cout << "Top " << topKNum << " configurations:" << std::endl;
+            topK.print(std::cout);
+        }
+    });
+    if(ofs.is_open()){
+        ofs.close();
+    }
+    if(divergedNum > 0){
+        std::cout << divergedNum << " configurations diverged." << std::endl;
+    }
+    if(strokeViolatedNum > 0){
+        std::cout << strokeViolatedNum << " configurations exceeded the NES stroke limit " << strokeLimit << "." << std::endl;
+    }
+    if(solver.isLinearPrescreen()){
+        std::cout << "Linear pre-screen: " << prescreenedNum << " of " << candidates.size() * NESSolver::caseNum3m3u
+        << " runs linearly stable, computed analytically." << std::endl;
+    }
+    if(warmStart){
+        std::cout << "Warm start: " << warmAccepted << " runs continued, " 
+        << warmRejected << " runs fell back to cold start." << std::endl;
+        if(warmChecked > 0){
+            std::cout << "Warm start check: " << warmMismatched << " of " << warmChecked 
+            << " configurations checked against a cold start landed on a different response; "
+            << warmRedone << " unchecked warm-started configurations were redone cold "
+            << "and warm start was turned off for the rest of their sweep lines." << std::endl;
+        }
+    }
+    if(topKNum > 0 && !topKFile.empty()){
+        topK.write(topKFile);
+    }
 }
 void NESSweeper::checkParamsIntegrity(){
     std::vector<bool> mrFlag(nesNum - 1, false);
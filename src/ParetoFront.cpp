@@ -0,0 +1,101 @@
+#include "ParetoFront.h"
+#include <fstream>
+#include <sstream>
+#include <iomanip>
+#include <algorithm>
+#include <cstdio>
+#include <stdexcept>
+ParetoFront::ParetoFront(const std::vector<std::string>& objectiveNames_, const std::string& labelHeader_):
+objectiveNames(objectiveNames_),
+labelHeader(labelHeader_)
+{
+
+}
+bool ParetoFront::weaklyDominates(const std::vector<double>& a, const std::vector<double>& b){
+    for(size_t i = 0; i < a.size(); i++){
+        if(a[i] > b[i]){
+            return false;
+        }
+    }
+    return true;
+}
+bool ParetoFront::insert(const std::vector<double>& objectives, const std::string& label){
+    if(objectives.size() != objectiveNames.size()){
+        throw std::runtime_error("Number of objectives does not match the Pareto front.");
+    }
+    for(const auto& p : points){
+        if(weaklyDominates(p.objectives, objectives)){
+            return false;
+        }
+    }
+    points.erase(
+        std::remove_if(points.begin(), points.end(), [&objectives](const ParetoPoint& p){
+            return weaklyDominates(objectives, p.objectives);
+        }),
+        points.end()
+    );
+    points.push_back(ParetoPoint{objectives, label});
+    return true;
+}
+std::string ParetoFront::header() const{
+    std::string h;
+    for(const auto& name : objectiveNames){
+        h += name + ",";
+    }
+    return h + labelHeader;
+}
+void ParetoFront::load(const std::string& file){
+    std::ifstream ifs(file);
+    if(!ifs){
+        return;
+    }
+    std::string line;
+    if(!std::getline(ifs, line) || line != header()){
+        return;
+    }
+    while(std::getline(ifs, line)){
+        if(line.empty()){
+            continue;
+        }
+        std::istringstream iss(line);
+        std::vector<double> objectives;
+        std::string word;
+        for(size_t i = 0; i < objectiveNames.size() && std::getline(iss, word, ','); i++){
+            objectives.push_back(std::stod(word));
+        }
+        std::string label;
+        std::getline(iss, label);
+        if(objectives.size() == objectiveNames.size()){
+            insert(objectives, label);
+        }
+    }
+}
+void ParetoFront::write(const std::string& file) const{
+    std::vector<ParetoPoint> sorted = points;
+    std::sort(sorted.begin(), sorted.end(), [](const ParetoPoint& a, const ParetoPoint& b){
+        return a.objectives < b.objectives;
+    });
+    // 先写临时文件再替换, 保证扫描过程中读取到的前沿文件总是完整的
+    std::string tmpFile = file + ".tmp";
+    {
+        std::ofstream ofs(tmpFile);
+        if(!ofs){
+            throw std::runtime_error("Cannot open Pareto front file \"" + tmpFile + "\".");
+        }
+        ofs << std::scientific << std::setprecision(8);
+        ofs << header() << "\n";
+        for(const auto& p : sorted){
+            for(const double v : p.objectives){
+                ofs << v << ",";
+            }
+            ofs << p.label << "\n";
+        }
+    }
+#ifdef _WIN32
+    // Windows 的 rename 不覆盖已有文件; POSIX 上 rename 原子地替换, 文件始终存在
+    std::remove(file.c_str());
+#endif
+    if(std::rename(tmpFile.c_str(), file.c_str()) != 0){
+        throw std::runtime_error("Cannot write Pareto front file \"" + file + "\".");
+    }
+}
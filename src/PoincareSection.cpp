@@ -0,0 +1,57 @@
+#include "PoincareSection.h"
+#include "ResponseStatistics.h"
+#include <iomanip>
+PoincareSection::PoincareSection(int dimension_, int index_, double startTime_, const DerivativeFunction& derivative_):
+dimension(dimension_),
+index(index_),
+startTime(startTime_),
+derivative(derivative_),
+prevState(dimension_),
+prevDeriv(dimension_),
+deriv(dimension_){
+}
+void PoincareSection::update(const std::vector<double>& state){
+    if(hasPrev && prevState[index] < 0.0 && state[index] >= 0.0 && state[0] >= startTime){
+        const double h = state[0] - prevState[0];
+        derivative(prevState, prevDeriv);
+        derivative(state, deriv);
+        double s = hermiteRoot(prevState[index], prevDeriv[index], state[index], deriv[index], h);
+        if(prevState[0] + s * h >= startTime){
+            for(int i = 0; i < dimension; i++){
+                points.push_back(hermiteValue(prevState[i], prevDeriv[i], state[i], deriv[i], h, s));
+            }
+        }
+    }
+    for(int i = 0; i < dimension; i++){
+        prevState[i] = state[i];
+    }
+    hasPrev = true;
+}
+std::string stateHeader(int nesNumber){
+    std::string header = "t,yp";
+    for(int i = 1; i <= nesNumber; i++){
+        header += ",ya" + std::to_string(i);
+    }
+    header += ",ypv";
+    for(int i = 1; i <= nesNumber; i++){
+        header += ",yav" + std::to_string(i);
+    }
+    return header;
+}
+void writeSectionPoints(std::ostream& os, const std::vector<double>& prefix, const std::vector<double>& points,
+    size_t dimension, bool binary){
+    for(size_t p = 0; p + dimension <= points.size(); p += dimension){
+        if(binary){
+            os.write(reinterpret_cast<const char*>(prefix.data()), prefix.size() * sizeof(double));
+            os.write(reinterpret_cast<const char*>(points.data() + p), dimension * sizeof(double));
+            continue;
+        }
+        os << std::scientific << std::setprecision(10);
+        for(double v : prefix){
+            os << v << ",";
+        }
+        for(size_t i = 0; i < dimension; i++){
+            os << points[p + i] << (i + 1 < dimension ? "," : "\n");
+        }
+    }
+}
@@ -0,0 +1,145 @@
+#include "ResponseStatistics.h"
+#include <cmath>
+#include <limits>
+#include <algorithm>
+double hermiteValue(double y0, double v0, double y1, double v1, double h, double s){
+    double delta = y1 - y0;
+    double B = 3.0 * delta - 2.0 * h * v0 - h * v1;
+    double C = -2.0 * delta + h * v0 + h * v1;
+    return y0 + s * (h * v0 + s * (B + s * C));
+}
+double hermitePeak(double y0, double v0, double y1, double v1, double h, double sBegin, double sEnd){
+    double peak = std::max(sBegin == 0.0 ? y0 : hermiteValue(y0, v0, y1, v1, h, sBegin),
+        sEnd == 1.0 ? y1 : hermiteValue(y0, v0, y1, v1, h, sEnd));
+    // p(s) = y0 + h v0 s + B s^2 + C s^3, s in [0, 1]
+    double delta = y1 - y0;
+    double B = 3.0 * delta - 2.0 * h * v0 - h * v1;
+    double C = -2.0 * delta + h * v0 + h * v1;
+    // p'(s) = h v0 + 2 B s + 3 C s^2 = 0
+    double qa = 3.0 * C, qb = 2.0 * B, qc = h * v0;
+    double roots[2];
+    int rootNum = 0;
+    if(std::abs(qa) <= 1e-12 * (std::abs(qb) + std::abs(qc))){
+        if(qb != 0.0){
+            roots[rootNum++] = -qc / qb;
+        }
+    }
+    else{
+        double disc = qb * qb - 4.0 * qa * qc;
+        if(disc >= 0.0){
+            // 避免相消的求根公式
+            double q = -0.5 * (qb + std::copysign(std::sqrt(disc), qb));
+            roots[rootNum++] = q / qa;
+            if(q != 0.0){
+                roots[rootNum++] = qc / q;
+            }
+        }
+    }
+    for(int i = 0; i < rootNum; i++){
+        double s = roots[i];
+        if(s > sBegin && s < sEnd){
+            peak = std::max(peak, y0 + s * (h * v0 + s * (B + s * C)));
+        }
+    }
+    return peak;
+}
+double hermiteRoot(double y0, double v0, double y1, double v1, double h){
+    // 以线性插值为初值的 Newton 迭代, 越出括区间时退回二分
+    double lo = 0.0, hi = 1.0;
+    double s = y0 / (y0 - y1);
+    for(int i = 0; i < 20; i++){
+        double p = hermiteValue(y0, v0, y1, v1, h, s);
+        if(p < 0.0){
+            lo = s;
+        }
+        else{
+            hi = s;
+        }
+        double delta = y1 - y0;
+        double B = 3.0 * delta - 2.0 * h * v0 - h * v1;
+        double C = -2.0 * delta + h * v0 + h * v1;
+        double dp = h * v0 + s * (2.0 * B + 3.0 * C * s);
+        double next = dp != 0.0 ? s - p / dp : 0.5 * (lo + hi);
+        if(!(next > lo && next < hi)){
+            next = 0.5 * (lo + hi);
+        }
+        if(std::abs(next - s) < 1e-14){
+            return next;
+        }
+        s = next;
+    }
+    return s;
+}
+double hermiteSquareIntegral(double y0, double v0, double y1, double v1, double h, double sBegin, double sEnd){
+    // 4 点 Gauss-Legendre 对不超过 7 次的多项式精确, 三次插值的平方为 6 次
+    static const double nodes[4] = { -0.86113631159405258, -0.33998104358485626, 0.33998104358485626, 0.86113631159405258 };
+    static const double weights[4] = { 0.34785484513745386, 0.65214515486254614, 0.65214515486254614, 0.34785484513745386 };
+    const double mid = 0.5 * (sBegin + sEnd);
+    const double half = 0.5 * (sEnd - sBegin);
+    double sum = 0.0;
+    for(int k = 0; k < 4; k++){
+        double y = hermiteValue(y0, v0, y1, v1, h, mid + half * nodes[k]);
+        sum += weights[k] * y * y;
+    }
+    return half * h * sum;
+}
+ResponseStatistics::ResponseStatistics(size_t index_, size_t velocityIndex_, double startTime_, int refIndex_, int refVelocityIndex_):
+index(index_),
+velocityIndex(velocityIndex_),
+refIndex(refIndex_),
+refVelocityIndex(refVelocityIndex_),
+startTime(startTime_),
+maxValue(std::numeric_limits<double>::lowest()),
+minValue(std::numeric_limits<double>::max()){
+}
+void ResponseStatistics::update(const std::vector<double>& state){
+    double t = state[0];
+    double y = state[index];
+    double v = state[velocityIndex];
+    if(refIndex >= 0){
+        y -= state[refIndex];
+        v -= state[refVelocityIndex];
+    }
+    if(sampleNum > 0 && t > startTime){
+        double h = t - prevTime;
+        // 跨过统计起点的步只积分起点之后的部分
+        double s0 = prevTime >= startTime ? 0.0 : (startTime - prevTime) / h;
+        double ys = s0 == 0.0 ? prevY : hermiteValue(prevY, prevV, y, v, h, s0);
+        integral += hermiteSquareIntegral(prevY, prevV, y, v, h, s0, 1.0);
+        duration += (1.0 - s0) * h;
+        maxValue = std::max(maxValue, std::max(ys, y));
+        minValue = std::min(minValue, std::min(ys, y));
+        // 速度由正变负: 峰值在步内; 由负变正: 谷值在步内
+        if(prevV > 0.0 && v <= 0.0){
+            maxValue = std::max(maxValue, hermitePeak(prevY, prevV, y, v, h, s0));
+        }
+        else if(prevV < 0.0 && v >= 0.0){
+            minValue = std::min(minValue, -hermitePeak(-prevY, -prevV, -y, -v, h, s0));
+        }
+    }
+    prevTime = t;
+    prevY = y;
+    prevV = v;
+    sampleNum++;
+}
+double ResponseStatistics::getRms() const{
+    if(duration <= 0.0){
+        return 0.0;
+    }
+    return std::sqrt(integral / duration);
+}
+double ResponseStatistics::getMax() const{
+    if(duration <= 0.0){
+        return 0.0;
+    }
+    return maxValue;
+}
+double ResponseStatistics::getMin() const{
+    if(duration <= 0.0){
+        return 0.0;
+    }
+    return minValue;
+}
+double ResponseStatistics::getAbsMax() const{
+    return std::max(std::abs(getMax()), std::abs(getMin()));
+}
@@ -0,0 +1,87 @@
+#include "Rosenbrock.h"
+#include "DenseLinearAlgebra.h"
+#include <cmath>
+#include <stdexcept>
+#include <algorithm>
+RosenbrockTableau RosenbrockTableau::ros2(){
+    const double g = 1.0 + 1.0 / std::sqrt(2.0);
+    RosenbrockTableau t;
+    t.stages = 2;
+    t.gamma = g;
+    t.a = {0.0, 0.0,
+           1.0 / g, 0.0};
+    t.c = {0.0, 0.0,
+           -2.0 / g, 0.0};
+    t.m = {1.5 / g, 0.5 / g};
+    return t;
+}
+RosenbrockTableau RosenbrockTableau::rodas3(){
+    RosenbrockTableau t;
+    t.stages = 4;
+    t.gamma = 0.5;
+    t.a = {0.0, 0.0, 0.0, 0.0,
+           0.0, 0.0, 0.0, 0.0,
+           2.0, 0.0, 0.0, 0.0,
+           2.0, 0.0, 1.0, 0.0};
+    t.c = {0.0, 0.0, 0.0, 0.0,
+           4.0, 0.0, 0.0, 0.0,
+           1.0, -1.0, 0.0, 0.0,
+           1.0, -1.0, -8.0 / 3.0, 0.0};
+    t.m = {2.0, 0.0, 1.0, 1.0};
+    return t;
+}
+void Rosenbrock::prepare() {
+	const size_t n = static_cast<size_t>(dimension);
+	matrix.resize(n * n);
+	stages.resize(n * tableau.stages);
+	rhs.resize(n);
+	tempState.resize(n);
+	pivots.resize(n);
+}
+void Rosenbrock::step(std::vector<double>& state) {
+	const size_t n = static_cast<size_t>(dimension);
+	const int s = tableau.stages;
+	// 原位组装 I / (h gamma) - J 并分解
+	jacobian(state, matrix);
+	const double diag = 1.0 / (stepSize * tableau.gamma);
+	for (size_t i = 0; i < n * n; ++i) {
+		matrix[i] = -matrix[i];
+	}
+	for (size_t i = 0; i < n; ++i) {
+		matrix[i * n + i] += diag;
+	}
+	if (!luFactor(matrix, pivots, n)) {
+		throw std::runtime_error("Rosenbrock: singular iteration matrix.");
+	}
+	const double invH = 1.0 / stepSize;
+	for (int i = 0; i < s; ++i) {
+		tempState = state;
+		for (int j = 0; j < i; ++j) {
+			const double a = tableau.a[i * s + j];
+			if (a != 0.0) {
+				for (size_t k = 0; k < n; ++k) {
+					tempState[k] += a * stages[j * n + k];
+				}
+			}
+		}
+		evaluate(tempState, rhs);
+		for (int j = 0; j < i; ++j) {
+			const double c = tableau.c[i * s + j] * invH;
+			if (c != 0.0) {
+				for (size_t k = 0; k < n; ++k) {
+					rhs[k] += c * stages[j * n + k];
+				}
+			}
+		}
+		luSolve(matrix, pivots, rhs, n);
+		std::copy(rhs.begin(), rhs.end(), stages.begin() + i * n);
+	}
+	for (int i = 0; i < s; ++i) {
+		const double m = tableau.m[i];
+		if (m != 0.0) {
+			for (size_t k = 0; k < n; ++k) {
+				state[k] += m * stages[i * n + k];
+			}
+		}
+	}
+}
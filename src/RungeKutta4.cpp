@@ -1,39 +1,37 @@
 #include "RungeKutta4.h"
-void RungeKutta4::integrate(std::vector<double>& state) {
-	stepFunction(state);
-	std::vector<double> k1(dimension), k2(dimension), k3(dimension), k4(dimension), tempState(dimension);
-	for (int step = 0; step < numSteps; ++step) {
-		
-		// Compute k1
-		for (int i = 0; i < dimension; ++i) {
-			k1[i] = stepSize * functions[i](state);
-		}
-		// Compute k2
-		for (int i = 0; i < dimension; ++i) {
-			tempState[i] = state[i] + 0.5 * k1[i];
-		}
-		for (int i = 0; i < dimension; ++i) {
-			k2[i] = stepSize * functions[i](tempState);
-		}
-		// Compute k3
-		for (int i = 0; i < dimension; ++i) {
-			tempState[i] = state[i] + 0.5 * k2[i];
-		}
-		for (int i = 0; i < dimension; ++i) {
-			k3[i] = stepSize * functions[i](tempState);
-		}
-		// Compute k4
-		for (int i = 0; i < dimension; ++i) {
-			tempState[i] = state[i] + k3[i];
-		}
-		for (int i = 0; i < dimension; ++i) {
-			k4[i] = stepSize * functions[i](tempState);
-		}
-		// Update state
-		for (int i = 0; i < dimension; ++i) {
-			state[i] += (k1[i] + 2 * k2[i] + 2 * k3[i] + k4[i]) / 6.0;
-		}
-		// Call the step function
-		stepFunction(state);
+void RungeKutta4::prepare() {
+	k1.resize(dimension);
+	k2.resize(dimension);
+	k3.resize(dimension);
+	k4.resize(dimension);
+	tempState.resize(dimension);
+}
+void RungeKutta4::evaluateScaled(const std::vector<double>& state, std::vector<double>& k) {
+	evaluate(state, k);
+	for (int i = 0; i < dimension; ++i) {
+		k[i] *= stepSize;
 	}
-}
\ No newline at end of file
+}
+void RungeKutta4::step(std::vector<double>& state) {
+	// Compute k1
+	evaluateScaled(state, k1);
+	// Compute k2
+	for (int i = 0; i < dimension; ++i) {
+		tempState[i] = state[i] + 0.5 * k1[i];
+	}
+	evaluateScaled(tempState, k2);
+	// Compute k3
+	for (int i = 0; i < dimension; ++i) {
+		tempState[i] = state[i] + 0.5 * k2[i];
+	}
+	evaluateScaled(tempState, k3);
+	// Compute k4
+	for (int i = 0; i < dimension; ++i) {
+		tempState[i] = state[i] + k3[i];
+	}
+	evaluateScaled(tempState, k4);
+	// Update state
+	for (int i = 0; i < dimension; ++i) {
+		state[i] += (k1[i] + 2 * k2[i] + 2 * k3[i] + k4[i]) / 6.0;
+	}
+}
@@ -0,0 +1,227 @@
+#include "ShootingSolver.h"
+#include "NESSolver.h"
+#include "RungeKutta4.h"
+#include "DenseLinearAlgebra.h"
+#include "NESFDMUtils.h"
+#include <cmath>
+#include <algorithm>
+#include <limits>
+ShootingSolver::ShootingSolver(NESSolver& solver_):
+solver(solver_),
+dim(solver_.getDimension()),
+ypvIndex(solver_.getNESNumber() + 2)
+{
+
+}
+bool ShootingSolver::initialGuess(std::vector<double>& x0, double& period){
+    const double h = solver.getTimeStepSize();
+    const double fn = solver.getMainFN();
+    std::vector<double> state = solver.getStartState();
+    DerivativeFunction deriv = [this](const std::vector<double>& s, std::vector<double>& d){
+        solver.computeDerivatives(s, d);
+    };
+    RungeKutta4 transient(dim, h, static_cast<int>(solver.getShootingTransientTao() / fn / h), deriv);
+    transient.setDivergenceCheck(1, solver.getDivergenceAStar() * solver.getMainD());
+    transient.integrate(state);
+    if(transient.isDiverged()){
+        return false;
+    }
+    // 继续积分, 记录 yp_dot 由正变负 (位移峰值) 的两个相邻时刻
+    std::vector<double> prev = state;
+    std::vector<double> crossing;
+    double firstTime = -1.0;
+    bool found = false;
+    RungeKutta4 tracker(dim, h, static_cast<int>(10.0 / fn / h), deriv);
+    tracker.setStepFunction([&](const std::vector<double>& s){
+        if(found){
+            return;
+        }
+        if(prev[ypvIndex] > 0.0 && s[ypvIndex] <= 0.0){
+            double ratio = prev[ypvIndex] / (prev[ypvIndex] - s[ypvIndex]);
+            double t = prev[0] + ratio * (s[0] - prev[0]);
+            if(firstTime < 0.0){
+                firstTime = t;
+                crossing.resize(dim);
+                for(size_t i = 0; i < dim; i++){
+                    crossing[i] = prev[i] + ratio * (s[i] - prev[i]);
+                }
+            }
+            else{
+                period = t - firstTime;
+                found = true;
+            }
+        }
+        prev = s;
+    });
+    tracker.integrate(state);
+    if(!found || period <= 0.0){
+        return false;
+    }
+    x0 = crossing;
+    x0[0] = 0.0;
+    x0[ypvIndex] = 0.0;
+    return true;
+}
+void ShootingSolver::integratePeriod(const std::vector<double>& x0, double period, std::vector<double>& xT,
+    std::vector<double>* monodromy, double* yRms, double* yMax){
+    const int steps = std::max(static_cast<int>(std::ceil(period / solver.getTimeStepSize())), 32);
+    const double h = period / steps;
+    const size_t total = monodromy ? dim + dim * dim : dim;
+
+    std::vector<double> aug(total, 0.0);
+    std::copy(x0.begin(), x0.end(), aug.begin());
+    if(monodromy){
+        for(size_t i = 0; i < dim; i++){
+            aug[dim + i * dim + i] = 1.0;
+        }
+    }
+    std::vector<double> stateBuf(dim), derivBuf(dim), jac(dim * dim);
+    DerivativeFunction deriv = [&](const std::vector<double>& s, std::vector<double>& d){
+        std::copy(s.begin(), s.begin() + dim, stateBuf.begin());
+        solver.computeDerivatives(stateBuf, derivBuf);
+        std::copy(derivBuf.begin(), derivBuf.end(), d.begin());
+        if(total == dim){
+            return;
+        }
+        // 变分方程: Phi' = J(x) Phi
+        solver.computeJacobian(stateBuf, jac);
+        for(size_t i = 0; i < dim; i++){
+            for(size_t j = 0; j < dim; j++){
+                double sum = 0.0;
+                for(size_t k = 0; k < dim; k++){
+                    sum += jac[i * dim + k] * s[dim + k * dim + j];
+                }
+                d[dim + i * dim + j] = sum;
+            }
+        }
+    };
+    // 周期函数的梯形公式即等权平均, 首尾只计一次
+    double sumSq = 0.0;
+    double maxVal = std::numeric_limits<double>::lowest();
+    int sampleCount = 0;
+    RungeKutta4 rk4(static_cast<int>(total), h, steps, deriv);
+    rk4.setStepFunction([&](const std::vector<double>& s){
+        if(sampleCount < steps){
+            sumSq += s[1] * s[1];
+            maxVal = std::max(maxVal, s[1]);
+        }
+        sampleCount++;
+    });
+    rk4.integrate(aug);
+
+    xT.assign(aug.begin(), aug.begin() + dim);
+    if(monodromy){
+        monodromy->assign(aug.begin() + dim, aug.end());
+    }
+    if(yRms){
+        *yRms = std::sqrt(sumSq / steps) / solver.getMainD();
+    }
+    if(yMax){
+        *yMax = maxVal / solver.getMainD();
+    }
+}
+PeriodicOrbit ShootingSolver::solve(){
+    PeriodicOrbit orbit;
+    std::vector<double> x0;
+    double period = 0.0;
+    if(!initialGuess(x0, period)){
+        return orbit;
+    }
+    // 未知量: 除时间和 yp_dot 外的状态分量, 以及周期 T
+    const size_t n = dim - 1;
+    std::vector<size_t> freeIndex;
+    for(size_t i = 1; i < dim; i++){
+        if(i != ypvIndex){
+            freeIndex.push_back(i);
+        }
+    }
+    auto residualNorm = [&](const std::vector<double>& x, const std::vector<double>& xT){
+        double r = 0.0, scale = 1e-12;
+        for(size_t i = 1; i < dim; i++){
+            r = std::max(r, std::abs(xT[i] - x[i]));
+            scale = std::max(scale, std::abs(x[i]));
+        }
+        return r / scale;
+    };
+    std::vector<double> xT, monodromy, a(n * n), rhs(n), fT(dim);
+    std::vector<int> pivots;
+    for(int iter = 0; iter < maxIterations; iter++){
+        integratePeriod(x0, period, xT, &monodromy, nullptr, nullptr);
+        double res = residualNorm(x0, xT);
+        orbit.iterations = iter + 1;
+        if(res < tolerance){
+            orbit.converged = true;
+            break;
+        }
+        solver.computeDerivatives(xT, fT);
+        for(size_t i = 1; i < dim; i++){
+            for(size_t c = 0; c < freeIndex.size(); c++){
+                size_t j = freeIndex[c];
+                a[(i - 1) * n + c] = monodromy[i * dim + j] - (i == j ? 1.0 : 0.0);
+            }
+            a[(i - 1) * n + n - 1] = fT[i];
+            rhs[i - 1] = -(xT[i] - x0[i]);
+        }
+        if(!luFactor(a, pivots, n)){
+            return orbit;
+        }
+        luSolve(a, pivots, rhs, n);
+        // 残差不下降时步长减半
+        double lambda = 1.0;
+        std::vector<double> xTrial(dim), xTrialT;
+        double periodTrial = period;
+        for(int k = 0; k < 8; k++){
+            xTrial = x0;
+            for(size_t c = 0; c < freeIndex.size(); c++){
+                xTrial[freeIndex[c]] += lambda * rhs[c];
+            }
+            periodTrial = period + lambda * rhs[n - 1];
+            if(periodTrial > 0.0){
+                integratePeriod(xTrial, periodTrial, xTrialT, nullptr, nullptr, nullptr);
+                if(isFiniteValue(xTrialT[1]) && residualNorm(xTrial, xTrialT) < res){
+                    break;
+                }
+            }
+            lambda *= 0.5;
+        }
+        if(periodTrial <= 0.0){
+            return orbit;
+        }
+        x0 = xTrial;
+        period = periodTrial;
+    }
+    if(!orbit.converged){
+        return orbit;
+    }
+    analyzeOrbit(x0, period, orbit);
+    return orbit;
+}
+void ShootingSolver::analyzeOrbit(const std::vector<double>& x0, double period, PeriodicOrbit& orbit){
+    const size_t n = dim - 1;
+    std::vector<double> xT, monodromy;
+    integratePeriod(x0, period, xT, &monodromy, &orbit.yRms, &orbit.yMax);
+    orbit.initialState = x0;
+    orbit.periodTao = period * solver.getMainFN();
+
+    // Floquet 乘子: 去掉时间分量后的单值矩阵特征值
+    std::vector<double> m(n * n);
+    for(size_t i = 1; i < dim; i++){
+        for(size_t j = 1; j < dim; j++){
+            m[(i - 1) * n + (j - 1)] = monodromy[i * dim + j];
+        }
+    }
+    orbit.floquetMultipliers = eigenvalues(m, n);
+    size_t trivial = 0;
+    for(size_t i = 1; i < n; i++){
+        if(std::abs(orbit.floquetMultipliers[i] - 1.0) < std::abs(orbit.floquetMultipliers[trivial] - 1.0)){
+            trivial = i;
+        }
+    }
+    orbit.maxFloquet = 0.0;
+    for(size_t i = 0; i < n; i++){
+        if(i != trivial){
+            orbit.maxFloquet = std::max(orbit.maxFloquet, std::abs(orbit.floquetMultipliers[i]));
+        }
+    }
+    orbit.stable = orbit.maxFloquet < 1.0 + 1e-6;
+}
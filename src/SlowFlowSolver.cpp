@@ -0,0 +1,275 @@
+#include "SlowFlowSolver.h"
+#include "NESSolver.h"
+#include "RungeKutta4.h"
+#include "DenseLinearAlgebra.h"
+#include <cmath>
+#include <algorithm>
+#include <limits>
+#include <array>
+SlowFlowSolver::SlowFlowSolver(NESSolver& solver_):
+solver(solver_),
+dofNum(1 + solver_.getNESNumber()),
+omegaN(2 * PI * solver_.getMainFN()),
+D(solver_.getMainD())
+{
+    state.resize(solver.getDimension());
+    deriv.resize(solver.getDimension());
+}
+void SlowFlowSolver::average(const std::vector<std::complex<double>>& phi, double omega, std::vector<std::complex<double>>& rate){
+    const size_t n = dofNum - 1;
+    const double ampScale = omegaN * D;
+    const double rateScale = 1.0 / (omegaN * omegaN * D * sampleNum);
+    // 快变相位的采样点固定, 只算一次
+    static const std::array<std::complex<double>, sampleNum> phases = []{
+        std::array<std::complex<double>, sampleNum> p;
+        for(size_t j = 0; j < sampleNum; j++){
+            p[j] = std::polar(1.0, 2 * PI * static_cast<double>(j) / sampleNum);
+        }
+        return p;
+    }();
+    std::fill(rate.begin(), rate.end(), std::complex<double>(0.0, 0.0));
+    for(size_t j = 0; j < sampleNum; j++){
+        const std::complex<double> e = phases[j];
+        state[0] = 0.0;
+        for(size_t q = 0; q < dofNum; q++){
+            const std::complex<double> z = phi[q] * e * ampScale;
+            state[q + 1] = z.imag() / omega;
+            state[q + n + 2] = z.real();
+        }
+        solver.computeDerivatives(state, deriv);
+        for(size_t q = 0; q < dofNum; q++){
+            const double g = deriv[q + n + 2] + omega * omega * state[q + 1];
+            rate[q] += g * std::conj(e) * rateScale;
+        }
+    }
+}
+void SlowFlowSolver::fixedPointResidual(const std::vector<double>& u, std::vector<double>& r){
+    std::vector<std::complex<double>> phi(dofNum), rate(dofNum);
+    phi[0] = u[0];
+    for(size_t q = 1; q < dofNum; q++){
+        phi[q] = std::complex<double>(u[2 * q], u[2 * q + 1]);
+    }
+    average(phi, u[1] * omegaN, rate);
+    for(size_t q = 0; q < dofNum; q++){
+        r[2 * q] = rate[q].real();
+        r[2 * q + 1] = rate[q].imag();
+    }
+}
+bool SlowFlowSolver::newton(std::vector<double>& u, int& iterations){
+    const size_t total = u.size();
+    auto infNorm = [](const std::vector<double>& v){
+        double m = 0.0;
+        for(double x : v){
+            m = std::max(m, std::abs(x));
+        }
+        return m;
+    };
+    std::vector<double> r(total), rTrial(total), rPerturbed(total), jac(total * total), step(total), uTrial(total);
+    std::vector<int> pivots;
+    fixedPointResidual(u, r);
+    double norm = infNorm(r);
+    for(int iter = 0; iter < maxIterations; iter++){
+        iterations++;
+        if(!isFiniteValue(norm)){
+            return false;
+        }
+        if(norm < tolerance){
+            // 收敛到静止解时不作为周期解
+            return std::abs(u[0]) > 1e-6;
+        }
+        for(size_t c = 0; c < total; c++){
+            const double h = 1e-7 * std::max(std::abs(u[c]), 1e-3);
+            const double saved = u[c];
+            u[c] = saved + h;
+            fixedPointResidual(u, rPerturbed);
+            u[c] = saved;
+            for(size_t i = 0; i < total; i++){
+                jac[i * total + c] = (rPerturbed[i] - r[i]) / h;
+            }
+        }
+        if(!luFactor(jac, pivots, total)){
+            return false;
+        }
+        for(size_t i = 0; i < total; i++){
+            step[i] = -r[i];
+        }
+        luSolve(jac, pivots, step, total);
+        // 与谐波平衡法相同: 限制频率和主结构振幅的单步变化, 残差不下降时步长减半
+        double lambda = 1.0;
+        if(std::abs(step[1]) > 0.1 * u[1]){
+            lambda = 0.1 * u[1] / std::abs(step[1]);
+        }
+        if(std::abs(step[0]) > 0.5 * std::abs(u[0])){
+            lambda = std::min(lambda, 0.5 * std::abs(u[0]) / std::abs(step[0]));
+        }
+        double trialNorm = norm;
+        for(int k = 0; k < 10; k++){
+            for(size_t i = 0; i < total; i++){
+                uTrial[i] = u[i] + lambda * step[i];
+            }
+            fixedPointResidual(uTrial, rTrial);
+            trialNorm = infNorm(rTrial);
+            if(trialNorm < norm){
+                break;
+            }
+            lambda *= 0.5;
+        }
+        if(!(trialNorm < norm) || uTrial[1] <= 0.0){
+            return false;
+        }
+        u.swap(uTrial);
+        r.swap(rTrial);
+        norm = trialNorm;
+    }
+    return false;
+}
+bool SlowFlowSolver::isStable(const std::vector<std::complex<double>>& phi, double omega){
+    const size_t total = 2 * dofNum;
+    std::vector<std::complex<double>> base(dofNum), perturbed(dofNum), phiPerturbed = phi;
+    average(phi, omega, base);
+    std::vector<double> jac(total * total);
+    for(size_t c = 0; c < total; c++){
+        const size_t q = c / 2;
+        const double h = 1e-7 * std::max(std::abs(phi[q]), 1e-3);
+        phiPerturbed[q] += (c % 2 == 0) ? std::complex<double>(h, 0.0) : std::complex<double>(0.0, h);
+        average(phiPerturbed, omega, perturbed);
+        phiPerturbed[q] = phi[q];
+        for(size_t i = 0; i < dofNum; i++){
+            const std::complex<double> d = (perturbed[i] - base[i]) / h;
+            jac[(2 * i) * total + c] = d.real();
+            jac[(2 * i + 1) * total + c] = d.imag();
+        }
+    }
+    std::vector<std::complex<double>> lambda = eigenvalues(jac, total);
+    // 相位不变性对应模最小的特征值 (理论上为 0)
+    size_t neutral = 0;
+    for(size_t i = 1; i < total; i++){
+        if(std::abs(lambda[i]) < std::abs(lambda[neutral])){
+            neutral = i;
+        }
+    }
+    for(size_t i = 0; i < total; i++){
+        if(i != neutral && lambda[i].real() > 1e-6){
+            return false;
+        }
+    }
+    return true;
+}
+void SlowFlowSolver::integrateEnvelope(SlowFlowResult& result){
+    const size_t n = dofNum - 1;
+    const size_t dim = solver.getDimension();
+    const double omega = result.fixedPoint ? result.omega : 2 * PI * solver.getMainFR();
+    result.omega = omega;
+
+    // 冷启动与时域积分一致: 各自由度位移 initialAStar * D 静止释放, 即 phi = i omega x
+    std::vector<double> s(1 + 2 * dofNum, 0.0);
+    for(size_t q = 0; q < dofNum; q++){
+        s[2 * q + 2] = omega * solver.getInitialAStar() / omegaN;
+    }
+    // 步长: 取 0.2 tao, 并受平均后最大阻尼率 (时域 Jacobian 对角元的一半) 限制
+    std::vector<double> start = solver.getStartState(), jac(dim * dim);
+    solver.computeJacobian(start, jac);
+    double rate = 0.0;
+    for(size_t q = 0; q < dofNum; q++){
+        rate = std::max(rate, 0.5 * std::abs(jac[(q + n + 2) * dim + q + n + 2]));
+    }
+    double h = 0.2 / solver.getMainFN();
+    if(rate > 0.0){
+        h = std::min(h, 1.0 / rate);
+    }
+    const double totalTime = solver.getTotalTao() / solver.getMainFN();
+    const double calcStartTime = solver.getResultCalcStartTao() / solver.getMainFN();
+    const int steps = static_cast<int>(std::ceil(totalTime / h));
+    h = totalTime / steps;
+
+    std::vector<std::complex<double>> phi(dofNum), rateBuf(dofNum);
+    DerivativeFunction flow = [&](const std::vector<double>& x, std::vector<double>& d){
+        for(size_t q = 0; q < dofNum; q++){
+            phi[q] = std::complex<double>(x[2 * q + 1], x[2 * q + 2]);
+        }
+        average(phi, omega, rateBuf);
+        d[0] = 1.0;
+        for(size_t q = 0; q < dofNum; q++){
+            d[2 * q + 1] = rateBuf[q].real() * omegaN;
+            d[2 * q + 2] = rateBuf[q].imag() * omegaN;
+        }
+    };
+    // 包络 |phi0| 对应的振幅为 |phi0| omegaN D / omega
+    const double toAStar = omegaN / omega;
+    double sumSq = 0.0, maxAmp = 0.0;
+    size_t count = 0;
+    RungeKutta4 rk4(static_cast<int>(s.size()), h, steps, flow);
+    rk4.setStepFunction([&](const std::vector<double>& x){
+        if(x[0] < calcStartTime){
+            return;
+        }
+        const double amp = std::hypot(x[1], x[2]) * toAStar;
+        sumSq += 0.5 * amp * amp;
+        maxAmp = std::max(maxAmp, amp);
+        count++;
+    });
+    rk4.setDivergenceCheck(1, solver.getDivergenceAStar() / toAStar);
+    rk4.integrate(s);
+    if(rk4.isDiverged()){
+        result.diverged = true;
+        result.divergedTao = rk4.getCompletedSteps() * h * solver.getMainFN();
+        result.yRms = 0.0;
+        result.yMax = 0.0;
+        return;
+    }
+    result.amplitudes.resize(dofNum);
+    for(size_t q = 0; q < dofNum; q++){
+        result.amplitudes[q] = std::complex<double>(s[2 * q + 1], s[2 * q + 2]) * omegaN * D;
+    }
+    result.yRms = count > 0 ? std::sqrt(sumSq / count) : 0.0;
+    result.yMax = maxAmp;
+}
+SlowFlowResult SlowFlowSolver::solve(){
+    SlowFlowResult result;
+    const size_t total = 2 * dofNum;
+    // 初值与谐波平衡法相同: 主结构相位 0, NES 振幅加倍并滞后 90 度, 依次尝试几个振幅
+    const double seeds[] = {1.0, 1.5, 2.0, 0.5};
+    std::vector<double> u(total);
+    for(double seed : seeds){
+        const double amplitude = seed * solver.getInitialAStar() * solver.getMainFR() / solver.getMainFN();
+        std::fill(u.begin(), u.end(), 0.0);
+        u[0] = amplitude;
+        u[1] = solver.getMainFR() / solver.getMainFN();
+        for(size_t q = 1; q < dofNum; q++){
+            u[2 * q + 1] = -2.0 * amplitude;
+        }
+        if(newton(u, result.iterations)){
+            result.fixedPoint = true;
+            break;
+        }
+    }
+    if(result.fixedPoint){
+        result.omega = u[1] * omegaN;
+        std::vector<std::complex<double>> phi(dofNum);
+        phi[0] = u[0];
+        for(size_t q = 1; q < dofNum; q++){
+            phi[q] = std::complex<double>(u[2 * q], u[2 * q + 1]);
+        }
+        result.stable = isStable(phi, result.omega);
+        if(result.stable){
+            result.amplitudes.resize(dofNum);
+            for(size_t q = 0; q < dofNum; q++){
+                result.amplitudes[q] = phi[q] * omegaN * D;
+            }
+            result.yMax = std::abs(phi[0]) * omegaN / result.omega;
+            result.yRms = result.yMax / std::sqrt(2.0);
+            return result;
+        }
+    }
+    integrateEnvelope(result);
+    return result;
+}
+std::vector<double> SlowFlowSolver::toState(const SlowFlowResult& result) const{
+    const size_t n = dofNum - 1;
+    std::vector<double> s(solver.getDimension(), 0.0);
+    for(size_t q = 0; q < dofNum && q < result.amplitudes.size(); q++){
+        s[q + 1] = result.amplitudes[q].imag() / result.omega;
+        s[q + n + 2] = result.amplitudes[q].real();
+    }
+    return s;
+}
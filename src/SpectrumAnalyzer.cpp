@@ -0,0 +1,133 @@
+#include "SpectrumAnalyzer.h"
+#include "FFT.h"
+#include <cmath>
+#include <complex>
+#include <algorithm>
+SpectrumAnalyzer::SpectrumAnalyzer(double startTime_, size_t stride_):
+startTime(startTime_),
+stride(std::max<size_t>(stride_, 1)){
+}
+void SpectrumAnalyzer::addChannel(int index, int refIndex){
+    indices.push_back(index);
+    refIndices.push_back(refIndex);
+    samples.emplace_back();
+}
+void SpectrumAnalyzer::reserve(size_t sampleNum){
+    for(auto& s : samples){
+        s.reserve(sampleNum);
+    }
+}
+size_t SpectrumAnalyzer::strideFor(double taoStepSize){
+    return std::max<size_t>(static_cast<size_t>(std::round(1.0 / 64.0 / taoStepSize)), 1);
+}
+void SpectrumAnalyzer::update(const std::vector<double>& state){
+    if(state[0] < startTime){
+        return;
+    }
+    if(stepNum++ % stride != 0){
+        return;
+    }
+    if(samples.empty() || samples[0].empty()){
+        firstTime = state[0];
+    }
+    lastTime = state[0];
+    for(size_t c = 0; c < indices.size(); c++){
+        double y = state[indices[c]];
+        if(refIndices[c] >= 0){
+            y -= state[refIndices[c]];
+        }
+        samples[c].push_back(y);
+    }
+}
+std::vector<SpectralFeatures> SpectrumAnalyzer::analyze(double timeScale) const{
+    std::vector<SpectralFeatures> result(samples.size());
+    if(samples.empty() || samples[0].size() < 16){
+        return result;
+    }
+    const double dt = (lastTime - firstTime) * timeScale / (samples[0].size() - 1);
+    for(size_t c = 0; c < samples.size(); c++){
+        result[c] = features(samples[c], dt);
+    }
+    return result;
+}
+SpectralFeatures SpectrumAnalyzer::features(const std::vector<double>& x, double dt){
+    SpectralFeatures f;
+    const size_t n = x.size();
+    const size_t m = nextPowerOfTwo(n);
+    double mean = 0.0;
+    for(double v : x){
+        mean += v;
+    }
+    mean /= n;
+
+    // 功率谱 (Hann 窗)
+    std::vector<std::complex<double>> data(m, 0.0);
+    for(size_t j = 0; j < n; j++){
+        double w = 0.5 - 0.5 * std::cos(2.0 * PI * j / (n - 1));
+        data[j] = w * (x[j] - mean);
+    }
+    fft(data);
+    const size_t half = m / 2;
+    std::vector<double> power(half + 1);
+    for(size_t k = 0; k <= half; k++){
+        power[k] = std::norm(data[k]);
+    }
+    size_t peak = 1;
+    for(size_t k = 2; k < half; k++){
+        if(power[k] > power[peak]){
+            peak = k;
+        }
+    }
+    if(power[peak] <= 0.0){
+        return f;
+    }
+    // 对数幅值的抛物线插值修正峰值位置
+    double shift = 0.0;
+    if(power[peak - 1] > 0.0 && power[peak + 1] > 0.0){
+        double a = std::log(power[peak - 1]), b = std::log(power[peak]), c = std::log(power[peak + 1]);
+        double denom = a - 2.0 * b + c;
+        if(denom < 0.0){
+            shift = 0.5 * (a - c) / denom;
+        }
+    }
+    const double df = 1.0 / (m * dt);
+    f.dominantFrequency = (peak + shift) * df;
+    double total = 0.0, sub = 0.0, super = 0.0;
+    for(size_t k = 1; k <= half; k++){
+        double freq = k * df;
+        total += power[k];
+        if(freq < 0.7 * f.dominantFrequency){
+            sub += power[k];
+        }
+        else if(freq > 1.5 * f.dominantFrequency){
+            super += power[k];
+        }
+    }
+    f.subharmonicFraction = sub / total;
+    f.superharmonicFraction = super / total;
+
+    // 解析信号: 去掉负频率和 1.5 倍主频以上的超谐波 (否则波形畸变也会表现为包络起伏), 正频率加倍;
+    // 两端各 10% 受截断影响, 不计入包络
+    std::fill(data.begin(), data.end(), 0.0);
+    for(size_t j = 0; j < n; j++){
+        data[j] = x[j] - mean;
+    }
+    fft(data);
+    const size_t cutoff = std::min(half, static_cast<size_t>(1.5 * f.dominantFrequency / df) + 1);
+    for(size_t k = 1; k < cutoff; k++){
+        data[k] *= 2.0;
+    }
+    for(size_t k = cutoff; k < m; k++){
+        data[k] = 0.0;
+    }
+    fft(data, true);
+    const size_t trim = n / 10;
+    double envMax = 0.0, envMin = std::numeric_limits<double>::max();
+    for(size_t j = trim; j < n - trim; j++){
+        double env = std::abs(data[j]) / m;
+        envMax = std::max(envMax, env);
+        envMin = std::min(envMin, env);
+    }
+    f.modulationIndex = envMax + envMin > 0.0 ? (envMax - envMin) / (envMax + envMin) : 0.0;
+    return f;
+}
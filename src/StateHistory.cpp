@@ -0,0 +1,97 @@
+#include "StateHistory.h"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <stdexcept>
+#ifndef _WIN32
+#include <sys/mman.h>
+#include <unistd.h>
+#include <cstdlib>
+#endif
+StateHistory::StateHistory(size_t dimension_, size_t capacity_, const std::string& backingDir):
+dimension(dimension_),
+capacity(std::max<size_t>(capacity_, 1)){
+    const size_t bytes = dimension * capacity * sizeof(double);
+    if(!backingDir.empty()){
+#ifndef _WIN32
+        std::string path = backingDir + "/nesfdm_history_XXXXXX";
+        int fd = mkstemp(&path[0]);
+        if(fd < 0){
+            throw std::runtime_error("Cannot create history file in \"" + backingDir + "\".");
+        }
+        unlink(path.c_str());
+        if(ftruncate(fd, static_cast<off_t>(bytes)) != 0){
+            close(fd);
+            throw std::runtime_error("Cannot allocate history file of " + std::to_string(bytes) + " bytes.");
+        }
+        void* p = mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+        close(fd);
+        if(p == MAP_FAILED){
+            throw std::runtime_error("Cannot map history file.");
+        }
+        data = static_cast<double*>(p);
+        mapped = true;
+        mappedBytes = bytes;
+        return;
+#else
+        throw std::runtime_error("File-backed history is not supported on this platform.");
+#endif
+    }
+    data = new double[dimension * capacity];
+}
+StateHistory::~StateHistory(){
+#ifndef _WIN32
+    if(mapped){
+        munmap(data, mappedBytes);
+        return;
+    }
+#endif
+    delete[] data;
+}
+void StateHistory::push(const std::vector<double>& state){
+    if(count >= capacity){
+        throw std::runtime_error("State history capacity exceeded.");
+    }
+    for(size_t c = 0; c < dimension; c++){
+        data[c * capacity + count] = state[c];
+    }
+    count++;
+}
+size_t StateHistory::lowerBound(double startTime) const{
+    const double* t = column(0);
+    return static_cast<size_t>(std::lower_bound(t, t + count, startTime) - t);
+}
+// 以下归约为连续内存上的简单循环, 在 -O3 -ffast-math 下由编译器向量化
+double StateHistory::rms(size_t c, size_t first) const{
+    if(first >= count){
+        return 0.0;
+    }
+    const double* x = column(c);
+    double sum = 0.0;
+    for(size_t i = first; i < count; i++){
+        sum += x[i] * x[i];
+    }
+    return std::sqrt(sum / (count - first));
+}
+double StateHistory::max(size_t c, size_t first) const{
+    if(first >= count){
+        return 0.0;
+    }
+    const double* x = column(c);
+    double m = std::numeric_limits<double>::lowest();
+    for(size_t i = first; i < count; i++){
+        m = x[i] > m ? x[i] : m;
+    }
+    return m;
+}
+double StateHistory::min(size_t c, size_t first) const{
+    if(first >= count){
+        return 0.0;
+    }
+    const double* x = column(c);
+    double m = std::numeric_limits<double>::max();
+    for(size_t i = first; i < count; i++){
+        m = x[i] < m ? x[i] : m;
+    }
+    return m;
+}
@@ -0,0 +1,55 @@
+#include "ThreadPool.h"
+#include <algorithm>
+ThreadPool::ThreadPool(unsigned int threadNum){
+    threadNum = std::max(threadNum, 1u);
+    for(unsigned int i = 0; i < threadNum; i++){
+        workers.emplace_back(&ThreadPool::workerLoop, this);
+    }
+}
+ThreadPool::~ThreadPool(){
+    {
+        std::lock_guard<std::mutex> lock(mtx);
+        stopping = true;
+    }
+    taskCv.notify_all();
+    for(auto& w : workers){
+        w.join();
+    }
+}
+void ThreadPool::submit(std::function<void()> task){
+    {
+        std::lock_guard<std::mutex> lock(mtx);
+        tasks.push(std::move(task));
+    }
+    taskCv.notify_one();
+}
+void ThreadPool::wait(){
+    std::unique_lock<std::mutex> lock(mtx);
+    doneCv.wait(lock, [this](){ return tasks.empty() && running == 0; });
+}
+void ThreadPool::workerLoop(){
+    while(true){
+        std::function<void()> task;
+        {
+            std::unique_lock<std::mutex> lock(mtx);
+            taskCv.wait(lock, [this](){ return stopping || !tasks.empty(); });
+            if(tasks.empty()){
+                return;
+            }
+            task = std::move(tasks.front());
+            tasks.pop();
+            running++;
+        }
+        // 任务自行处理异常, 这里只保证线程不退出
+        try{
+            task();
+        }
+        catch(...){
+        }
+        {
+            std::lock_guard<std::mutex> lock(mtx);
+            running--;
+        }
+        doneCv.notify_all();
+    }
+}
@@ -0,0 +1,52 @@
+#include "TopKTracker.h"
+#include <fstream>
+#include <iomanip>
+#include <algorithm>
+#include <stdexcept>
+TopKTracker::TopKTracker(size_t k_, const std::string& labelHeader_):
+k(k_),
+labelHeader(labelHeader_)
+{
+    if(k == 0){
+        throw std::runtime_error("K of top-K configurations must be greater than 0.");
+    }
+}
+bool TopKTracker::insert(double objective, const std::string& label){
+    if(heap.size() < k){
+        heap.push(RankedConfig{objective, label});
+        return true;
+    }
+    if(objective < heap.top().objective){
+        heap.pop();
+        heap.push(RankedConfig{objective, label});
+        return true;
+    }
+    return false;
+}
+std::vector<RankedConfig> TopKTracker::sorted() const{
+    auto copy = heap;
+    std::vector<RankedConfig> configs;
+    configs.reserve(copy.size());
+    while(!copy.empty()){
+        configs.push_back(copy.top());
+        copy.pop();
+    }
+    std::reverse(configs.begin(), configs.end());
+    return configs;
+}
+void TopKTracker::print(std::ostream& os) const{
+    os << "rank,objective," << labelHeader << "\n";
+    int rank = 1;
+    for(const auto& c : sorted()){
+        os << rank << "," << std::scientific << std::setprecision(8) << c.objective << "," << c.label << "\n";
+        rank++;
+    }
+    os << std::defaultfloat;
+}
+void TopKTracker::write(const std::string& file) const{
+    std::ofstream ofs(file);
+    if(!ofs){
+        throw std::runtime_error("Cannot open top-K file \"" + file + "\".");
+    }
+    print(ofs);
+}
@@ -0,0 +1,251 @@
+// 核心数值模块的自检, 由 ctest 运行: 任一检查失败时返回非 0
+#include "NESSolver.h"
+#include "ColumnarHistory.h"
+#include "ResponseStatistics.h"
+#include "FFT.h"
+#include "DenseLinearAlgebra.h"
+#include <cmath>
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <complex>
+#include <algorithm>
+
+static int failures = 0;
+
+static void check(bool condition, const std::string& what){
+    if(!condition){
+        failures++;
+        std::cerr << "FAILED: " << what << std::endl;
+    }
+}
+static bool near(double a, double b, double relTol, double absTol = 0.0){
+    return std::abs(a - b) <= relTol * std::max(std::abs(a), std::abs(b)) + absTol;
+}
+
+// 三次多项式 c0 + c1 t + c2 t^2 + c3 t^3 及其导数
+static double cubic(const double c[4], double t){
+    return c[0] + t * (c[1] + t * (c[2] + t * c[3]));
+}
+static double cubicSlope(const double c[4], double t){
+    return c[1] + t * (2.0 * c[2] + t * 3.0 * c[3]);
+}
+// 多项式平方在 [t0, t1] 上的积分 (展开系数后逐项积分)
+static double cubicSquareIntegral(const double c[4], double t0, double t1){
+    double d[7] = {0.0};
+    for(int i = 0; i < 4; i++){
+        for(int j = 0; j < 4; j++){
+            d[i + j] += c[i] * c[j];
+        }
+    }
+    double sum = 0.0;
+    for(int k = 0; k < 7; k++){
+        sum += d[k] * (std::pow(t1, k + 1) - std::pow(t0, k + 1)) / (k + 1);
+    }
+    return sum;
+}
+
+// Hermite 插值对三次多项式精确, 峰值, 零点和平方积分都有解析值
+static void testHermite(){
+    const double c[4] = {0.3, -1.2, 0.8, 2.0};
+    const double h = 0.5;
+    const double y0 = cubic(c, 0.0), v0 = cubicSlope(c, 0.0), y1 = cubic(c, h), v1 = cubicSlope(c, h);
+    for(double s : {0.0, 0.1, 0.37, 0.5, 0.9, 1.0}){
+        check(near(hermiteValue(y0, v0, y1, v1, h, s), cubic(c, s * h), 1e-14, 1e-15), "hermiteValue reproduces a cubic");
+    }
+    check(near(hermiteSquareIntegral(y0, v0, y1, v1, h, 0.0, 1.0), cubicSquareIntegral(c, 0.0, h), 1e-13),
+        "hermiteSquareIntegral over the whole step");
+    check(near(hermiteSquareIntegral(y0, v0, y1, v1, h, 0.25, 0.9), cubicSquareIntegral(c, 0.25 * h, 0.9 * h), 1e-13),
+        "hermiteSquareIntegral over a partial step");
+
+    // y = t - t^3 在 [0, 1] 上的最大值在 t = 1/sqrt(3)
+    const double p[4] = {0.0, 1.0, 0.0, -1.0};
+    const double peak = 2.0 / (3.0 * std::sqrt(3.0));
+    check(near(hermitePeak(cubic(p, 0.0), cubicSlope(p, 0.0), cubic(p, 1.0), cubicSlope(p, 1.0), 1.0), peak, 1e-14),
+        "hermitePeak finds the interior maximum");
+    check(near(hermitePeak(cubic(p, 0.0), cubicSlope(p, 0.0), cubic(p, 1.0), cubicSlope(p, 1.0), 1.0, 0.7, 1.0), cubic(p, 0.7), 1e-14),
+        "hermitePeak on a sub-interval past the maximum");
+
+    // y = (t - 0.2)(1 + t^2), 零点 t = 0.2
+    const double r[4] = {-0.2, 1.0, -0.2, 1.0};
+    const double hr = 0.5;
+    const double s = hermiteRoot(cubic(r, 0.0), cubicSlope(r, 0.0), cubic(r, hr), cubicSlope(r, hr), hr);
+    check(near(s * hr, 0.2, 1e-13), "hermiteRoot finds the zero crossing");
+}
+
+// 与直接求和的 DFT 比较, 并检查逆变换 (不归一化) 的往返
+static void testFFT(){
+    check(nextPowerOfTwo(1) == 1 && nextPowerOfTwo(5) == 8 && nextPowerOfTwo(8) == 8 && nextPowerOfTwo(1000) == 1024,
+        "nextPowerOfTwo");
+    const size_t n = 32;
+    std::vector<std::complex<double>> x(n);
+    for(size_t j = 0; j < n; j++){
+        x[j] = std::complex<double>(std::sin(0.7 * j * j + 0.3), std::cos(1.3 * j) - 0.2);
+    }
+    std::vector<std::complex<double>> X = x;
+    fft(X);
+    double scale = 0.0;
+    for(const auto& v : x){
+        scale += std::abs(v);
+    }
+    for(size_t k = 0; k < n; k++){
+        std::complex<double> sum(0.0, 0.0);
+        for(size_t j = 0; j < n; j++){
+            sum += x[j] * std::polar(1.0, -2.0 * PI * static_cast<double>(j * k % n) / n);
+        }
+        check(std::abs(X[k] - sum) <= 1e-12 * scale, "fft matches the direct DFT at k = " + std::to_string(k));
+    }
+    fft(X, true);
+    for(size_t j = 0; j < n; j++){
+        check(std::abs(X[j] / static_cast<double>(n) - x[j]) <= 1e-13 * scale, "inverse fft round trip");
+    }
+}
+
+// 每个期望的特征值都有足够接近的计算值, 实特征值的虚部严格为 0
+static void checkEigenvalues(const std::vector<double>& a, size_t n, const std::vector<std::complex<double>>& expected, const std::string& name){
+    std::vector<std::complex<double>> lambda = eigenvalues(a, n);
+    check(lambda.size() == n, name + ": eigenvalue count");
+    std::vector<bool> used(lambda.size(), false);
+    for(const auto& e : expected){
+        size_t best = lambda.size();
+        for(size_t i = 0; i < lambda.size(); i++){
+            if(!used[i] && (best == lambda.size() || std::abs(lambda[i] - e) < std::abs(lambda[best] - e))){
+                best = i;
+            }
+        }
+        bool found = best < lambda.size() && std::abs(lambda[best] - e) <= 1e-9 * std::max(std::abs(e), 1.0);
+        check(found, name + ": eigenvalue (" + std::to_string(e.real()) + ", " + std::to_string(e.imag()) + ")");
+        if(found){
+            used[best] = true;
+            if(e.imag() == 0.0){
+                check(lambda[best].imag() == 0.0, name + ": real eigenvalue has zero imaginary part");
+            }
+        }
+    }
+}
+static void testEigenvalues(){
+    // (x-1)(x-2)(x-3)(x-4) 的友矩阵
+    checkEigenvalues({
+        10.0, -35.0, 50.0, -24.0,
+        1.0, 0.0, 0.0, 0.0,
+        0.0, 1.0, 0.0, 0.0,
+        0.0, 0.0, 1.0, 0.0
+    }, 4, {1.0, 2.0, 3.0, 4.0}, "companion matrix");
+    // 块上三角: 旋转缩放块 -0.5 +- 2i 与实特征值 2
+    checkEigenvalues({
+        -0.5, -2.0, 1.0,
+        2.0, -0.5, 3.0,
+        0.0, 0.0, 2.0
+    }, 3, {{-0.5, 2.0}, {-0.5, -2.0}, 2.0}, "block triangular matrix");
+    // 行列尺度相差很大, 需要平衡
+    checkEigenvalues({
+        1.0, 1e6,
+        -1e-6, 1.0
+    }, 2, {{1.0, 1.0}, {1.0, -1.0}}, "badly scaled matrix");
+}
+
+static std::vector<std::vector<double>> readTextHistory(const std::string& path){
+    std::vector<std::vector<double>> rows;
+    std::ifstream ifs(path);
+    for(std::string line; std::getline(ifs, line);){
+        std::istringstream iss(line);
+        std::vector<double> row;
+        for(double v; iss >> v;){
+            row.push_back(v);
+        }
+        if(!row.empty()){
+            rows.push_back(row);
+        }
+    }
+    return rows;
+}
+// 同一次计算分别写出文本时程和分块列存储时程, 读取结果应一致 (文本为 11 位有效数字)
+static void testColumnarHistory(){
+    const std::string textPath = "test_core_history.txt";
+    const std::string binaryPath = "test_core_history.bin";
+    const size_t chunkSize = 64;
+    NESSolver solver(1);
+    solver.setNESMr(1, 0.01);
+    solver.setNESKr(1, 0.55);
+    solver.setNESCr(1, 0.65);
+    solver.setTotalTao(20.0);
+    solver.setResultCalcStartTao(10.0);
+    solver.setTaoStepSize(0.05);
+    solver.setOutput(textPath);
+    DisplacementResults textResult = solver.run();
+    solver.setOutput(binaryPath);
+    solver.setOutputChunkSize(chunkSize);
+    DisplacementResults binaryResult = solver.run();
+    check(textResult.yRms == binaryResult.yRms, "history format does not change the result");
+
+    std::vector<std::vector<double>> rows = readTextHistory(textPath);
+    ColumnarHistoryReader reader(binaryPath);
+    const size_t n = rows.size();
+    check(n > 2 * chunkSize, "text history has several chunks of samples");
+    check(reader.getSampleNum() == n, "sample count matches the text history");
+    check(reader.getDimension() == solver.getDimension(), "dimension");
+    check(reader.getChunkNum() == (n + chunkSize - 1) / chunkSize, "chunk count");
+    check(reader.findColumn("yp") == 1, "column names");
+    const double tol = 1e-9;
+    for(size_t c = 0; c < reader.getDimension(); c++){
+        std::vector<double> column = reader.readColumn(c, 0, n);
+        bool same = column.size() == n;
+        for(size_t i = 0; same && i < n; i++){
+            same = near(column[i], rows[i][c], tol, 1e-300);
+        }
+        check(same, "column " + std::to_string(c) + " matches the text history");
+    }
+    // 跨块读取
+    std::vector<double> part = reader.readColumn(1, chunkSize - 10, 30);
+    bool samePart = part.size() == 30;
+    for(size_t i = 0; samePart && i < part.size(); i++){
+        samePart = near(part[i], rows[chunkSize - 10 + i][1], tol, 1e-300);
+    }
+    check(samePart, "readColumn across a chunk boundary");
+
+    // 时间窗端点取在样本之间, 不受文本舍入影响: 窗内为样本 150 ~ 260
+    const double tBegin = 0.5 * (rows[149][0] + rows[150][0]), tEnd = 0.5 * (rows[260][0] + rows[261][0]);
+    std::vector<double> times, values;
+    reader.readWindow(1, tBegin, tEnd, times, values);
+    std::vector<double> expectedValues;
+    for(size_t i = 150; i <= 260; i++){
+        expectedValues.push_back(rows[i][1]);
+    }
+    bool sameWindow = values.size() == expectedValues.size() && times.size() == values.size();
+    for(size_t i = 0; sameWindow && i < values.size(); i++){
+        sameWindow = near(values[i], expectedValues[i], tol, 1e-300);
+    }
+    check(sameWindow, "readWindow matches the text history");
+
+    std::vector<ColumnarHistoryReader::ChunkSummary> summary = reader.overview(1, tBegin, tEnd);
+    check(summary.size() == 260 / chunkSize - 150 / chunkSize + 1, "overview covers the overlapping chunks");
+    for(size_t k = 0; k < summary.size(); k++){
+        const size_t first = (150 / chunkSize + k) * chunkSize;
+        const size_t last = std::min(first + chunkSize, n) - 1;
+        double lo = rows[first][1], hi = rows[first][1];
+        for(size_t i = first; i <= last; i++){
+            lo = std::min(lo, rows[i][1]);
+            hi = std::max(hi, rows[i][1]);
+        }
+        check(near(summary[k].tBegin, rows[first][0], tol) && near(summary[k].tEnd, rows[last][0], tol),
+            "overview chunk time range");
+        check(near(summary[k].min, lo, tol, 1e-300) && near(summary[k].max, hi, tol, 1e-300), "overview chunk min/max");
+    }
+    std::remove(textPath.c_str());
+    std::remove(binaryPath.c_str());
+}
+
+int main(){
+    testHermite();
+    testFFT();
+    testEigenvalues();
+    testColumnarHistory();
+    if(failures > 0){
+        std::cerr << failures << " checks failed." << std::endl;
+        return 1;
+    }
+    std::cout << "All checks passed." << std::endl;
+    return 0;
+}